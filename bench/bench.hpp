@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <ctl/generators.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/hypergraph_builder.hpp>
+
+namespace ctl::bench
+{
+class Vertex : public ctl::node<Vertex>
+{
+ public:
+   using ctl::node<Vertex>::node;
+};
+
+// The graph sizes and edge arities every benchmark runs with, set from the command line.
+struct config
+{
+   std::vector<std::int64_t> sizes{1 << 10, 1 << 14};
+   std::vector<std::int64_t> arities{2, 4};
+};
+
+void register_hypergraph_benchmarks(const config& config);
+void register_rewriter_benchmarks(const config& config);
+
+// node sets of edge_count random edges of the given arity over node_count nodes, the same for
+// every run
+inline std::vector<std::vector<std::uint32_t>> random_edges(size_t node_count, size_t edge_count,
+                                                            size_t arity)
+{
+   std::mt19937_64 engine(node_count * 31 + arity);
+   std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(node_count - 1));
+   std::vector<std::vector<std::uint32_t>> edges(edge_count, std::vector<std::uint32_t>(arity));
+
+   for (std::vector<std::uint32_t>& edge : edges)
+   {
+      for (std::uint32_t& node : edge)
+      {
+         node = pick(engine);
+      }
+   }
+
+   return edges;
+}
+
+// a graph of size nodes and size uniformly random edges of the given arity
+inline void build_random_graph(hypergraph<Vertex>& graph, size_t size, size_t arity)
+{
+   generate_uniform(graph, size, size, arity);
+}
+} // namespace ctl::bench
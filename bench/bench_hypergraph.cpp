@@ -0,0 +1,453 @@
+#include <deque>
+#include <unordered_set>
+
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+#include <ctl/compact_view.hpp>
+
+namespace ctl::bench
+{
+namespace
+{
+using node_sets = std::vector<std::vector<cxptr<Vertex>>>;
+
+// the node handles of random edges over the nodes of graph
+node_sets random_node_sets(const std::vector<cxptr<Vertex>>& nodes, size_t edge_count,
+                           size_t arity)
+{
+   node_sets sets;
+   sets.reserve(edge_count);
+
+   for (const std::vector<std::uint32_t>& edge : random_edges(nodes.size(), edge_count, arity))
+   {
+      std::vector<cxptr<Vertex>>& set = sets.emplace_back();
+      set.reserve(arity);
+
+      for (std::uint32_t node : edge)
+      {
+         set.push_back(nodes[node]);
+      }
+   }
+
+   return sets;
+}
+
+void add_node(benchmark::State& state)
+{
+   const size_t size = state.range(0);
+
+   for (auto _ : state)
+   {
+      hypergraph<Vertex> graph;
+
+      for (size_t node = 0; node < size; ++node)
+      {
+         benchmark::DoNotOptimize(graph.add_node());
+      }
+
+      state.PauseTiming();
+      graph = hypergraph<Vertex>();
+      state.ResumeTiming();
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void add_nodes(benchmark::State& state)
+{
+   const size_t size = state.range(0);
+
+   for (auto _ : state)
+   {
+      hypergraph<Vertex> graph;
+      benchmark::DoNotOptimize(graph.add_nodes(size));
+
+      state.PauseTiming();
+      graph = hypergraph<Vertex>();
+      state.ResumeTiming();
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void add_edge(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      node_sets sets = random_node_sets(graph.add_nodes(size), size, arity);
+      state.ResumeTiming();
+
+      for (std::vector<cxptr<Vertex>>& set : sets)
+      {
+         benchmark::DoNotOptimize(graph.add_edge(std::move(set)));
+      }
+
+      state.PauseTiming();
+      graph = hypergraph<Vertex>();
+      state.ResumeTiming();
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void add_edges(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      node_sets sets = random_node_sets(graph.add_nodes(size), size, arity);
+      state.ResumeTiming();
+
+      benchmark::DoNotOptimize(graph.add_edges(std::move(sets)));
+
+      state.PauseTiming();
+      graph = hypergraph<Vertex>();
+      state.ResumeTiming();
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void build(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+   const std::vector<std::vector<std::uint32_t>> edges = random_edges(size, size, arity);
+
+   for (auto _ : state)
+   {
+      hypergraph<Vertex> graph;
+      hypergraph_builder<Vertex> builder;
+      builder.reserve(size, size, size * arity);
+      builder.add_nodes(size);
+      builder.add_edges(edges);
+      benchmark::DoNotOptimize(builder.build(graph));
+
+      state.PauseTiming();
+      graph = hypergraph<Vertex>();
+      state.ResumeTiming();
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void remove_edge(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      build_random_graph(graph, size, arity);
+      const std::vector<cxptr<hyperedge<Vertex>>> edges = graph.get_edges();
+      state.ResumeTiming();
+
+      for (const cxptr<hyperedge<Vertex>>& edge : edges)
+      {
+         graph.remove_edge(edge);
+      }
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void remove_edges(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      build_random_graph(graph, size, arity);
+      const std::vector<cxptr<hyperedge<Vertex>>> edges = graph.get_edges();
+      state.ResumeTiming();
+
+      graph.remove_edges(edges);
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void remove_node(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      build_random_graph(graph, size, arity);
+      const std::vector<cxptr<Vertex>> nodes = graph.get_nodes();
+      state.ResumeTiming();
+
+      for (const cxptr<Vertex>& node : nodes)
+      {
+         graph.remove_node(node);
+      }
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void remove_nodes(benchmark::State& state)
+{
+   const size_t size  = state.range(0);
+   const size_t arity = state.range(1);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      build_random_graph(graph, size, arity);
+      const std::vector<cxptr<Vertex>> nodes = graph.get_nodes();
+      state.ResumeTiming();
+
+      graph.remove_nodes(nodes);
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+void incident_edges(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   build_random_graph(graph, state.range(0), state.range(1));
+
+   for (auto _ : state)
+   {
+      size_t pins = 0;
+
+      for (const Vertex& node : graph.nodes())
+      {
+         for (const hyperedge<Vertex>& edge : node.incident_edges())
+         {
+            benchmark::DoNotOptimize(&edge);
+            ++pins;
+         }
+      }
+
+      benchmark::DoNotOptimize(pins);
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void incident_nodes(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   build_random_graph(graph, state.range(0), state.range(1));
+
+   for (auto _ : state)
+   {
+      size_t pins = 0;
+
+      for (const hyperedge<Vertex>& edge : graph.edges())
+      {
+         for (const Vertex& node : edge.incident_nodes())
+         {
+            benchmark::DoNotOptimize(&node);
+            ++pins;
+         }
+      }
+
+      benchmark::DoNotOptimize(pins);
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void adjacent_nodes(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   build_random_graph(graph, state.range(0), state.range(1));
+
+   for (auto _ : state)
+   {
+      size_t adjacent = 0;
+
+      for (const Vertex& node : graph.nodes())
+      {
+         adjacent += node.count_adjacent_nodes();
+      }
+
+      benchmark::DoNotOptimize(adjacent);
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// breadth-first search over the nodes reachable from the first node through shared edges
+void traverse(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   build_random_graph(graph, state.range(0), state.range(1));
+   const Vertex& start = *graph.nodes().begin();
+
+   for (auto _ : state)
+   {
+      std::unordered_set<const Vertex*> visited{&start};
+      std::deque<const Vertex*> queue{&start};
+
+      while (!queue.empty())
+      {
+         const Vertex* node = queue.front();
+         queue.pop_front();
+
+         for (const Vertex& other : node->adjacent_nodes())
+         {
+            if (visited.insert(&other).second)
+            {
+               queue.push_back(&other);
+            }
+         }
+      }
+
+      benchmark::DoNotOptimize(visited.size());
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// the same search on the index-based compact view
+void traverse_compact(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   build_random_graph(graph, state.range(0), state.range(1));
+   const compact_view<Vertex> view = graph.freeze();
+
+   for (auto _ : state)
+   {
+      std::vector<bool> visited(view.node_count());
+      std::vector<std::uint32_t> queue{0};
+      visited[0] = true;
+
+      for (size_t next = 0; next < queue.size(); ++next)
+      {
+         for (std::uint32_t edge : view.get_incident_edges(queue[next]))
+         {
+            for (std::uint32_t other : view.get_incident_nodes(edge))
+            {
+               if (!visited[other])
+               {
+                  visited[other] = true;
+                  queue.push_back(other);
+               }
+            }
+         }
+      }
+
+      benchmark::DoNotOptimize(queue.size());
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// reads every node through its cxptr a number of times, locking it on every access
+void cxptr_access(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   const std::vector<cxptr<Vertex>> nodes = graph.add_nodes(state.range(0));
+
+   for (auto _ : state)
+   {
+      for (const cxptr<Vertex>& node : nodes)
+      {
+         for (int access = 0; access < 8; ++access)
+         {
+            benchmark::DoNotOptimize(node->get_handle());
+         }
+      }
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0) * 8);
+}
+
+// the same reads through a pinned reference, locking each node once
+void pinned_access(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   const std::vector<cxptr<Vertex>> nodes = graph.add_nodes(state.range(0));
+
+   for (auto _ : state)
+   {
+      for (const cxptr<Vertex>& node : nodes)
+      {
+         pinned<Vertex> vertex = node.pin();
+
+         for (int access = 0; access < 8; ++access)
+         {
+            benchmark::DoNotOptimize(vertex->get_handle());
+         }
+      }
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0) * 8);
+}
+
+void freeze(benchmark::State& state)
+{
+   hypergraph<Vertex> graph;
+   build_random_graph(graph, state.range(0), state.range(1));
+
+   for (auto _ : state)
+   {
+      benchmark::DoNotOptimize(graph.freeze());
+   }
+
+   state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+void register_hypergraph_benchmarks(const config& config)
+{
+   struct entry
+   {
+      const char* name;
+      void (*function)(benchmark::State&);
+   };
+
+   for (const entry& node_benchmark : {entry{"add_node", add_node},
+                                       entry{"add_nodes", add_nodes},
+                                       entry{"cxptr_access", cxptr_access},
+                                       entry{"pinned_access", pinned_access}})
+   {
+      benchmark::RegisterBenchmark(node_benchmark.name, node_benchmark.function)
+         ->ArgsProduct({config.sizes})
+         ->ArgNames({"size"});
+   }
+
+   for (const entry& edge_benchmark : {entry{"add_edge", add_edge},
+                                       entry{"add_edges", add_edges},
+                                       entry{"build", build},
+                                       entry{"remove_edge", remove_edge},
+                                       entry{"remove_edges", remove_edges},
+                                       entry{"remove_node", remove_node},
+                                       entry{"remove_nodes", remove_nodes},
+                                       entry{"incident_edges", incident_edges},
+                                       entry{"incident_nodes", incident_nodes},
+                                       entry{"adjacent_nodes", adjacent_nodes},
+                                       entry{"traverse", traverse},
+                                       entry{"traverse_compact", traverse_compact},
+                                       entry{"freeze", freeze}})
+   {
+      benchmark::RegisterBenchmark(edge_benchmark.name, edge_benchmark.function)
+         ->ArgsProduct({config.sizes, config.arities})
+         ->ArgNames({"size", "arity"});
+   }
+}
+} // namespace ctl::bench
@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+#include <ctl/rewriter.hpp>
+
+namespace ctl::bench
+{
+namespace
+{
+// the rule of the Wolfram model signature, which grows the graph by one node per event
+const cnr::Rule& signature_rule()
+{
+   static const cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+   return rule;
+}
+
+void seed_graph(hypergraph<Vertex>& graph)
+{
+   cxptr<Vertex> node = graph.add_node();
+   graph.add_edges({{node, node}, {node, node}});
+}
+
+// applies size events one at a time
+void rewrite_steps(benchmark::State& state, match_strategy strategy)
+{
+   const size_t size = state.range(0);
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      seed_graph(graph);
+      state.ResumeTiming();
+
+      rewriter<Vertex> rewriter(graph, signature_rule(), strategy);
+      benchmark::DoNotOptimize(rewriter.run(size));
+   }
+
+   state.SetItemsProcessed(state.iterations() * size);
+}
+
+// applies generations of non-overlapping events until there are at least size events
+void rewrite_generations(benchmark::State& state)
+{
+   const size_t size = state.range(0);
+   size_t events     = 0;
+
+   for (auto _ : state)
+   {
+      state.PauseTiming();
+      hypergraph<Vertex> graph;
+      seed_graph(graph);
+      state.ResumeTiming();
+
+      rewriter<Vertex> rewriter(graph, signature_rule());
+      rewriter.set_thread_count(1);
+
+      while (rewriter.get_event_count() < size)
+      {
+         rewriter.step_generation();
+      }
+
+      events += rewriter.get_event_count();
+   }
+
+   state.SetItemsProcessed(events);
+}
+} // namespace
+
+void register_rewriter_benchmarks(const config& config)
+{
+   benchmark::RegisterBenchmark("rewrite_steps", rewrite_steps, match_strategy::rescan)
+      ->ArgsProduct({config.sizes})
+      ->ArgNames({"size"});
+   benchmark::RegisterBenchmark("rewrite_steps_incremental", rewrite_steps,
+                                match_strategy::incremental)
+      ->ArgsProduct({config.sizes})
+      ->ArgNames({"size"});
+   benchmark::RegisterBenchmark("rewrite_generations", rewrite_generations)
+      ->ArgsProduct({config.sizes})
+      ->ArgNames({"size"});
+}
+} // namespace ctl::bench
@@ -0,0 +1,84 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "bench.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+// parses a comma separated list of positive numbers
+bool parse_list(std::string_view text, std::vector<std::int64_t>& values)
+{
+   std::vector<std::int64_t> parsed;
+   std::istringstream stream{std::string(text)};
+   std::string item;
+
+   while (std::getline(stream, item, ','))
+   {
+      char* end             = nullptr;
+      const long long value = std::strtoll(item.c_str(), &end, 10);
+
+      if (item.empty() || *end != '\0' || value <= 0)
+      {
+         return false;
+      }
+
+      parsed.push_back(value);
+   }
+
+   values = std::move(parsed);
+   return !values.empty();
+}
+} // namespace
+
+// Besides the Google Benchmark flags, accepts --sizes=1024,16384 and --arities=2,4 to choose the
+// synthetic graphs. Results are written as JSON with --benchmark_out=<file>.
+int main(int argc, char** argv)
+{
+   ctl::bench::config config;
+   int kept = 1;
+
+   for (int arg = 1; arg < argc; ++arg)
+   {
+      const std::string_view text = argv[arg];
+      bool valid                  = true;
+
+      if (text.starts_with("--sizes="))
+      {
+         valid = parse_list(text.substr(8), config.sizes);
+      }
+      else if (text.starts_with("--arities="))
+      {
+         valid = parse_list(text.substr(10), config.arities);
+      }
+      else
+      {
+         argv[kept++] = argv[arg];
+         continue;
+      }
+
+      if (!valid)
+      {
+         std::cerr << "Invalid list of positive numbers: " << text << '\n';
+         return 1;
+      }
+   }
+
+   argc = kept;
+   benchmark::Initialize(&argc, argv);
+
+   if (benchmark::ReportUnrecognizedArguments(argc, argv))
+   {
+      return 1;
+   }
+
+   ctl::bench::register_hypergraph_benchmarks(config);
+   ctl::bench::register_rewriter_benchmarks(config);
+   benchmark::RunSpecifiedBenchmarks();
+   benchmark::Shutdown();
+   return 0;
+}
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <ctl/compact_view.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/hypergraph_builder.hpp>
+#include <ctl/internal/mapped_file.hpp>
+
+namespace ctl
+{
+// Opts a node type into storing one trivially copyable record per node in the binary format.
+// Without a specialisation nodes are saved without payload and loaded default constructed.
+//
+//    template <>
+//    struct binary_payload<City>
+//    {
+//       using type = city_record;
+//       static city_record save(const City& city);
+//       static City load(const city_record& record);
+//    };
+template <typename T>
+struct binary_payload
+{
+   using type = void;
+};
+
+// The binary format stores the structure of a hypergraph as the arrays of its compact_view, so a
+// file can be used in place once mapped. All values are in the byte order of the machine that
+// wrote the file and every section starts at a multiple of 8 bytes:
+//
+//    header
+//    uint64 edge_offsets[edge_count + 1]    pins of edge i are pins[edge_offsets[i] ...]
+//    uint32 pins[pin_count]                 node indices, in the order the edges store them
+//    uint64 node_offsets[node_count + 1]
+//    uint32 node_edges[pin_count]           edge indices of every node in ascending order
+//    byte   payloads[node_count * payload_size]
+//
+// Nodes and edges are numbered in hypergraph<T>::get_nodes and get_edges order. Ids are not
+// stored, loading hands out new ones in file order.
+namespace binary_format
+{
+inline constexpr char magic[8]            = {'C', 'T', 'L', 'H', 'G', 'R', 'F', '\0'};
+inline constexpr std::uint32_t version    = 1;
+inline constexpr std::uint32_t byte_order = 0x01020304;
+
+struct header
+{
+   char magic[8];
+   std::uint32_t version;
+   std::uint32_t byte_order;
+   std::uint64_t node_count;
+   std::uint64_t edge_count;
+   std::uint64_t pin_count;
+   std::uint64_t payload_size;
+};
+
+static_assert(sizeof(header) % 8 == 0);
+
+inline constexpr std::uint64_t padded(std::uint64_t bytes)
+{
+   return (bytes + 7) / 8 * 8;
+}
+} // namespace binary_format
+
+// A hypergraph file mapped into memory and queried in place. Opening it only checks the header
+// and the section sizes, so it takes the same time for every file size, and pages are read from
+// disk as queries reach them. The view answers incidence queries like compact_view and can build
+// a hypergraph<T> from the file.
+class mapped_hypergraph
+{
+ public:
+   using index_type = std::uint32_t;
+
+   explicit mapped_hypergraph(const std::filesystem::path& path);
+
+   size_t node_count() const { return header_.node_count; }
+   size_t edge_count() const { return header_.edge_count; }
+   size_t pin_count() const { return header_.pin_count; }
+   size_t payload_size() const { return header_.payload_size; }
+
+   // whether the file is mapped rather than read into memory
+   bool is_mapped() const { return file_.is_mapped(); }
+
+   std::span<const index_type> get_incident_edges(index_type node) const;
+   std::span<const index_type> get_incident_nodes(index_type edge) const;
+
+   // the payload record of a node, which must have the size it was saved with
+   template <typename Payload>
+   Payload get_payload(index_type node) const;
+
+   // creates the nodes and edges of the file in a new hypergraph through hypergraph_builder
+   template <typename T>
+   hypergraph<T> materialize(size_t thread_count = 1) const;
+
+ private:
+   static std::span<const index_type> slice(const std::uint64_t* offsets,
+                                            const index_type* values, size_t count,
+                                            size_t value_count, index_type index);
+
+   internal::mapped_file file_;
+   binary_format::header header_{};
+   const std::uint64_t* edge_offsets_ = nullptr;
+   const index_type* pins_            = nullptr;
+   const std::uint64_t* node_offsets_ = nullptr;
+   const index_type* node_edges_      = nullptr;
+   const std::byte* payloads_         = nullptr;
+};
+
+// writes the structure of graph, and the node payloads if T has a binary_payload, to path
+template <typename T>
+void save_binary(const hypergraph<T>& graph, const std::filesystem::path& path);
+
+// reads a hypergraph file into a new hypergraph
+template <typename T>
+hypergraph<T> load_binary(const std::filesystem::path& path, size_t thread_count = 1)
+{
+   return mapped_hypergraph(path).materialize<T>(thread_count);
+}
+
+template <typename T>
+void save_binary(const hypergraph<T>& graph, const std::filesystem::path& path)
+{
+   using payload_type = typename binary_payload<T>::type;
+
+   const compact_view<T> view = graph.freeze();
+   binary_format::header header{};
+   std::memcpy(header.magic, binary_format::magic, sizeof(header.magic));
+   header.version    = binary_format::version;
+   header.byte_order = binary_format::byte_order;
+   header.node_count = view.node_count();
+   header.edge_count = view.edge_count();
+
+   if (header.node_count >= UINT32_MAX || header.edge_count >= UINT32_MAX)
+   {
+      throw std::length_error("The hypergraph is too large for the binary format.");
+   }
+
+   if constexpr (!std::is_void_v<payload_type>)
+   {
+      static_assert(std::is_trivially_copyable_v<payload_type>,
+                    "binary_payload records must be trivially copyable.");
+      header.payload_size = sizeof(payload_type);
+   }
+
+   std::vector<std::uint64_t> edge_offsets{0};
+   std::vector<std::uint32_t> pins;
+   std::vector<std::uint64_t> node_offsets{0};
+   std::vector<std::uint32_t> node_edges;
+   edge_offsets.reserve(view.edge_count() + 1);
+   node_offsets.reserve(view.node_count() + 1);
+
+   for (std::uint32_t edge = 0; edge < view.edge_count(); ++edge)
+   {
+      std::span<const std::uint32_t> nodes = view.get_incident_nodes(edge);
+      pins.insert(pins.end(), nodes.begin(), nodes.end());
+      edge_offsets.push_back(pins.size());
+   }
+
+   node_edges.reserve(pins.size());
+
+   for (std::uint32_t node = 0; node < view.node_count(); ++node)
+   {
+      std::span<const std::uint32_t> edges = view.get_incident_edges(node);
+      node_edges.insert(node_edges.end(), edges.begin(), edges.end());
+      node_offsets.push_back(node_edges.size());
+   }
+
+   header.pin_count = pins.size();
+
+   std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+   const char padding[8] = {};
+
+   auto write = [&stream, &padding](const void* data, std::uint64_t bytes)
+   {
+      stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+      stream.write(padding, static_cast<std::streamsize>(binary_format::padded(bytes) - bytes));
+   };
+
+   write(&header, sizeof(header));
+   write(edge_offsets.data(), edge_offsets.size() * sizeof(std::uint64_t));
+   write(pins.data(), pins.size() * sizeof(std::uint32_t));
+   write(node_offsets.data(), node_offsets.size() * sizeof(std::uint64_t));
+   write(node_edges.data(), node_edges.size() * sizeof(std::uint32_t));
+
+   if constexpr (!std::is_void_v<payload_type>)
+   {
+      std::vector<payload_type> payloads;
+      payloads.reserve(view.node_count());
+
+      for (const T& node : graph.nodes())
+      {
+         payloads.push_back(binary_payload<T>::save(node));
+      }
+
+      write(payloads.data(), payloads.size() * sizeof(payload_type));
+   }
+
+   if (!stream.flush())
+   {
+      throw std::runtime_error("Cannot write the hypergraph to " + path.string());
+   }
+}
+
+inline mapped_hypergraph::mapped_hypergraph(const std::filesystem::path& path) : file_(path)
+{
+   std::span<const std::byte> bytes = file_.bytes();
+
+   if (bytes.size() < sizeof(header_))
+   {
+      throw std::runtime_error(path.string() + " is not a hypergraph file.");
+   }
+
+   std::memcpy(&header_, bytes.data(), sizeof(header_));
+
+   if (std::memcmp(header_.magic, binary_format::magic, sizeof(header_.magic)) != 0)
+   {
+      throw std::runtime_error(path.string() + " is not a hypergraph file.");
+   }
+
+   if (header_.version != binary_format::version || header_.byte_order != binary_format::byte_order)
+   {
+      throw std::runtime_error(path.string() + " has an unsupported version or byte order.");
+   }
+
+   // the counts are untrusted, so every section size is checked against the remaining bytes
+   // before it is computed from them
+   size_t position = sizeof(header_);
+
+   auto section = [&bytes, &position, &path](std::uint64_t count, std::uint64_t element_size)
+   {
+      const size_t remaining = bytes.size() - position;
+
+      if (element_size != 0 && count > remaining / element_size)
+      {
+         throw std::runtime_error(path.string() + " is truncated.");
+      }
+
+      const std::byte* start = bytes.data() + position;
+      position += std::min<size_t>(binary_format::padded(count * element_size), remaining);
+      return start;
+   };
+
+   if (header_.node_count >= UINT32_MAX || header_.edge_count >= UINT32_MAX)
+   {
+      throw std::runtime_error(path.string() + " is too large for the binary format.");
+   }
+
+   edge_offsets_ = reinterpret_cast<const std::uint64_t*>(
+      section(header_.edge_count + 1, sizeof(std::uint64_t)));
+   pins_ = reinterpret_cast<const index_type*>(section(header_.pin_count, sizeof(index_type)));
+   node_offsets_ = reinterpret_cast<const std::uint64_t*>(
+      section(header_.node_count + 1, sizeof(std::uint64_t)));
+   node_edges_ =
+      reinterpret_cast<const index_type*>(section(header_.pin_count, sizeof(index_type)));
+   payloads_ = section(header_.node_count, header_.payload_size);
+}
+
+inline std::span<const mapped_hypergraph::index_type>
+mapped_hypergraph::slice(const std::uint64_t* offsets, const index_type* values, size_t count,
+                         size_t value_count, index_type index)
+{
+   if (index >= count)
+   {
+      throw std::out_of_range("Index is out of range of the mapped hypergraph.");
+   }
+
+   const std::uint64_t begin = offsets[index];
+   const std::uint64_t end   = offsets[index + 1];
+
+   if (begin > end || end > value_count)
+   {
+      throw std::runtime_error("The offsets of the mapped hypergraph are corrupt.");
+   }
+
+   return std::span<const index_type>(values + begin, end - begin);
+}
+
+inline std::span<const mapped_hypergraph::index_type>
+mapped_hypergraph::get_incident_edges(index_type node) const
+{
+   return slice(node_offsets_, node_edges_, node_count(), pin_count(), node);
+}
+
+inline std::span<const mapped_hypergraph::index_type>
+mapped_hypergraph::get_incident_nodes(index_type edge) const
+{
+   return slice(edge_offsets_, pins_, edge_count(), pin_count(), edge);
+}
+
+template <typename Payload>
+Payload mapped_hypergraph::get_payload(index_type node) const
+{
+   static_assert(std::is_trivially_copyable_v<Payload>);
+
+   if (sizeof(Payload) != payload_size())
+   {
+      throw std::invalid_argument("The payload type does not match the records of the file.");
+   }
+
+   if (node >= node_count())
+   {
+      throw std::out_of_range("Index is out of range of the mapped hypergraph.");
+   }
+
+   Payload payload;
+   std::memcpy(&payload, payloads_ + size_t{node} * sizeof(Payload), sizeof(Payload));
+   return payload;
+}
+
+template <typename T>
+hypergraph<T> mapped_hypergraph::materialize(size_t thread_count) const
+{
+   using payload_type = typename binary_payload<T>::type;
+
+   hypergraph_builder<T> builder;
+   builder.reserve(node_count(), edge_count(), pin_count());
+
+   if constexpr (std::is_void_v<payload_type>)
+   {
+      builder.add_nodes(node_count());
+   }
+   else
+   {
+      for (index_type node = 0; node < node_count(); ++node)
+      {
+         builder.add_node(binary_payload<T>::load(get_payload<payload_type>(node)));
+      }
+   }
+
+   // the builder checks the offsets and pins
+   std::vector<size_t> offsets(edge_offsets_, edge_offsets_ + edge_count() + 1);
+   builder.add_edges(offsets, std::span<const index_type>(pins_, pin_count()));
+
+   hypergraph<T> graph;
+   builder.build(graph, thread_count);
+   return graph;
+}
+} // namespace ctl
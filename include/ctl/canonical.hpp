@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+
+#include <ctl/cxptr.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/internal/canonical.hpp>
+#include <ctl/rule.h>
+
+namespace ctl
+{
+// A 128-bit hash of a canonical form. Isomorphic hypergraphs and rules always hash equally, so
+// states can be deduplicated by hash without pairwise isomorphism tests.
+using canonical_hash = internal::hash128;
+
+namespace internal
+{
+// the incidence structure of graph with its nodes numbered in get_nodes order
+template <typename T>
+coloured_hypergraph make_coloured_hypergraph(const hypergraph<T>& graph,
+                                             std::vector<cxptr<T>>* nodes = nullptr)
+{
+   std::vector<uint32_t> indices;
+   coloured_hypergraph coloured;
+
+   for (const T& node : graph.nodes())
+   {
+      const size_t slot = node.get_handle().index;
+
+      if (slot >= indices.size())
+      {
+         indices.resize(slot + 1);
+      }
+
+      indices[slot] = static_cast<uint32_t>(coloured.node_count++);
+   }
+
+   if (nodes != nullptr)
+   {
+      *nodes = graph.get_nodes();
+   }
+
+   std::vector<uint32_t> edge_nodes;
+
+   for (const hyperedge<T>& edge : graph.edges())
+   {
+      edge_nodes.clear();
+
+      for (const T& node : edge.incident_nodes())
+      {
+         edge_nodes.push_back(indices[node.get_handle().index]);
+      }
+
+      coloured.add_edge(0, edge_nodes);
+   }
+
+   return coloured;
+}
+} // namespace internal
+
+// the canonical hash of the incidence structure of graph, independent of node identities
+template <typename T>
+canonical_hash hash_canonical(const hypergraph<T>& graph)
+{
+   return internal::canonicalize(internal::make_coloured_hypergraph(graph)).hash();
+}
+
+// the canonical hash of rule, equal for rules that differ only in their labels and relation order
+inline canonical_hash hash_canonical(const cnr::Rule& rule)
+{
+   std::vector<size_t> labels;
+   return internal::canonicalize(internal::make_rule_hypergraph(rule.first, rule.second, labels))
+      .hash();
+}
+
+// the nodes of graph in canonical order. Isomorphisms between hypergraphs map the nodes of one
+// canonical order to the nodes at the same positions of the other.
+template <typename T>
+std::vector<cxptr<T>> canonical_order(const hypergraph<T>& graph)
+{
+   std::vector<cxptr<T>> nodes;
+   const internal::canonical_form form =
+      internal::canonicalize(internal::make_coloured_hypergraph(graph, &nodes));
+
+   std::vector<cxptr<T>> ordered(nodes.size());
+
+   for (size_t node = 0; node < nodes.size(); ++node)
+   {
+      ordered[form.labels[node]] = nodes[node];
+   }
+
+   return ordered;
+}
+
+// exact isomorphism test comparing canonical forms
+template <typename T, typename U>
+bool is_isomorphic(const hypergraph<T>& lhs, const hypergraph<U>& rhs)
+{
+   return internal::canonicalize(internal::make_coloured_hypergraph(lhs)).code ==
+          internal::canonicalize(internal::make_coloured_hypergraph(rhs)).code;
+}
+} // namespace ctl
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <ctl/cxptr.hpp>
+#include <ctl/handle.hpp>
+
+namespace ctl
+{
+template <typename T>
+class hyperedge;
+
+template <typename T>
+class hypergraph;
+
+// An immutable, index-based snapshot of the incidence structure of a hypergraph. Nodes and edges
+// are numbered 0..n-1 in the order hypergraph<T>::get_nodes and get_edges return them, and both
+// directions of the incidence relation are stored as CSR arrays (an offset array plus one
+// contiguous array of indices), so queries never touch the heap-allocated node and edge objects.
+// The view does not observe later changes to the hypergraph it was built from.
+template <typename T>
+class compact_view
+{
+ public:
+   using index_type = std::uint32_t;
+
+   compact_view() = default;
+   explicit compact_view(const hypergraph<T>& graph);
+   compact_view(const compact_view&)            = default;
+   compact_view& operator=(const compact_view&) = default;
+   compact_view(compact_view&&)                 = default;
+   compact_view& operator=(compact_view&&)      = default;
+   ~compact_view()                              = default;
+
+   size_t node_count() const { return node_offsets_.size() - 1; }
+   size_t edge_count() const { return edge_offsets_.size() - 1; }
+
+   cxptr<T> get_node(index_type node) const;
+   cxptr<hyperedge<T>> get_edge(index_type edge) const;
+
+   std::optional<index_type> index_of(const cxptr<T>& node) const;
+   std::optional<index_type> index_of(const cxptr<hyperedge<T>>& edge) const;
+   std::optional<index_type> index_of(handle<T> node) const;
+   std::optional<index_type> index_of(handle<hyperedge<T>> edge) const;
+
+   std::span<const index_type> get_incident_edges(index_type node) const;
+   std::span<const index_type> get_incident_nodes(index_type edge) const;
+   std::vector<index_type> get_adjacent_nodes(index_type node) const;
+   std::vector<index_type> get_adjacent_edges(index_type edge) const;
+
+   bool is_incident_to(index_type node, index_type edge) const;
+   bool is_adjacent_to(index_type node, index_type other_node) const;
+
+ private:
+   static constexpr index_type null_index = UINT32_MAX;
+
+   template <typename U>
+   static std::optional<index_type> lookup(const std::vector<handle<U>>& handles,
+                                           const std::vector<index_type>& slots, handle<U> key);
+
+   // the view index of a pin, which has to be a node of graph
+   index_type node_of(const hypergraph<T>& graph, const std::shared_ptr<T>& node) const;
+
+   // node -> incident edges, sorted ascending within each node
+   std::vector<size_t> node_offsets_{0};
+   std::vector<index_type> node_edges_;
+
+   // edge -> incident nodes, in the order the hyperedge stores them
+   std::vector<size_t> edge_offsets_{0};
+   std::vector<index_type> edge_nodes_;
+
+   std::vector<cxptr<T>> nodes_;
+   std::vector<cxptr<hyperedge<T>>> edges_;
+
+   // view index -> handle, and handle slot -> view index, so lookups are plain array accesses
+   std::vector<handle<T>> node_handles_;
+   std::vector<handle<hyperedge<T>>> edge_handles_;
+   std::vector<index_type> node_slots_;
+   std::vector<index_type> edge_slots_;
+};
+
+template <typename T>
+compact_view<T>::compact_view(const hypergraph<T>& graph)
+{
+   const size_t node_count = graph.nodes_.size();
+   const size_t edge_count = graph.edges_.size();
+
+   nodes_.reserve(node_count);
+   node_handles_.reserve(node_count);
+   node_slots_.assign(graph.nodes_.slot_count(), null_index);
+
+   for (const std::shared_ptr<T>& node : graph.nodes_)
+   {
+      node_slots_[node->get_handle().index] = static_cast<index_type>(nodes_.size());
+      node_handles_.push_back(node->get_handle());
+      nodes_.emplace_back(node);
+   }
+
+   edges_.reserve(edge_count);
+   edge_handles_.reserve(edge_count);
+   edge_slots_.assign(graph.edges_.slot_count(), null_index);
+   edge_offsets_.reserve(edge_count + 1);
+
+   std::vector<size_t> degrees(node_count, 0);
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : graph.edges_)
+   {
+      edge_slots_[edge->get_handle().index] = static_cast<index_type>(edges_.size());
+      edge_handles_.push_back(edge->get_handle());
+      edges_.emplace_back(edge);
+
+      for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+      {
+         const index_type node_index = node_of(graph, node);
+         edge_nodes_.push_back(node_index);
+         ++degrees[node_index];
+      }
+
+      edge_offsets_.push_back(edge_nodes_.size());
+   }
+
+   // counting sort of the pins by node gives the transposed CSR with every edge list already
+   // in ascending order, which is what is_incident_to relies on
+   node_offsets_.resize(node_count + 1);
+   node_offsets_[0] = 0;
+
+   for (size_t i = 0; i < node_count; ++i)
+   {
+      node_offsets_[i + 1] = node_offsets_[i] + degrees[i];
+   }
+
+   std::vector<size_t> cursor(node_offsets_.begin(), node_offsets_.end() - 1);
+   node_edges_.resize(edge_nodes_.size());
+
+   for (index_type edge = 0; edge < edge_count; ++edge)
+   {
+      for (size_t pin = edge_offsets_[edge]; pin < edge_offsets_[edge + 1]; ++pin)
+      {
+         node_edges_[cursor[edge_nodes_[pin]]++] = edge;
+      }
+   }
+}
+
+// Nodes of other hypergraphs can end up in an edge through hyperedge<T>::add_node. Their handle
+// may address a vacant slot or a different node of this graph, so the node itself is compared.
+template <typename T>
+typename compact_view<T>::index_type
+compact_view<T>::node_of(const hypergraph<T>& graph, const std::shared_ptr<T>& node) const
+{
+   const size_t slot       = node->get_handle().index;
+   const index_type index = slot < node_slots_.size() ? node_slots_[slot] : null_index;
+
+   if (index == null_index || graph.nodes_.values()[index] != node)
+   {
+      throw std::invalid_argument("An edge contains a node that is not in the hypergraph.");
+   }
+
+   return index;
+}
+
+template <typename T>
+cxptr<T> compact_view<T>::get_node(index_type node) const
+{
+   return nodes_.at(node);
+}
+
+template <typename T>
+cxptr<hyperedge<T>> compact_view<T>::get_edge(index_type edge) const
+{
+   return edges_.at(edge);
+}
+
+template <typename T>
+template <typename U>
+std::optional<typename compact_view<T>::index_type>
+compact_view<T>::lookup(const std::vector<handle<U>>& handles, const std::vector<index_type>& slots,
+                        handle<U> key)
+{
+   if (key.index < slots.size() && slots[key.index] != null_index &&
+       handles[slots[key.index]] == key)
+   {
+      return slots[key.index];
+   }
+
+   return std::nullopt;
+}
+
+template <typename T>
+std::optional<typename compact_view<T>::index_type>
+compact_view<T>::index_of(const cxptr<T>& node) const
+{
+   if (auto locked_node = node.lock())
+   {
+      std::optional<index_type> index = index_of(locked_node->get_handle());
+
+      if (index && nodes_[*index].lock() == locked_node)
+      {
+         return index;
+      }
+   }
+
+   return std::nullopt;
+}
+
+template <typename T>
+std::optional<typename compact_view<T>::index_type>
+compact_view<T>::index_of(const cxptr<hyperedge<T>>& edge) const
+{
+   if (auto locked_edge = edge.lock())
+   {
+      std::optional<index_type> index = index_of(locked_edge->get_handle());
+
+      if (index && edges_[*index].lock() == locked_edge)
+      {
+         return index;
+      }
+   }
+
+   return std::nullopt;
+}
+
+template <typename T>
+std::optional<typename compact_view<T>::index_type> compact_view<T>::index_of(handle<T> node) const
+{
+   return lookup(node_handles_, node_slots_, node);
+}
+
+template <typename T>
+std::optional<typename compact_view<T>::index_type>
+compact_view<T>::index_of(handle<hyperedge<T>> edge) const
+{
+   return lookup(edge_handles_, edge_slots_, edge);
+}
+
+template <typename T>
+std::span<const typename compact_view<T>::index_type>
+compact_view<T>::get_incident_edges(index_type node) const
+{
+   if (node >= node_count())
+   {
+      throw std::out_of_range("Node index is out of range of the compact view.");
+   }
+
+   return std::span<const index_type>(node_edges_.data() + node_offsets_[node],
+                                      node_offsets_[node + 1] - node_offsets_[node]);
+}
+
+template <typename T>
+std::span<const typename compact_view<T>::index_type>
+compact_view<T>::get_incident_nodes(index_type edge) const
+{
+   if (edge >= edge_count())
+   {
+      throw std::out_of_range("Edge index is out of range of the compact view.");
+   }
+
+   return std::span<const index_type>(edge_nodes_.data() + edge_offsets_[edge],
+                                      edge_offsets_[edge + 1] - edge_offsets_[edge]);
+}
+
+template <typename T>
+std::vector<typename compact_view<T>::index_type>
+compact_view<T>::get_adjacent_nodes(index_type node) const
+{
+   std::vector<index_type> adjacent_nodes;
+
+   for (index_type edge : get_incident_edges(node))
+   {
+      for (index_type other_node : get_incident_nodes(edge))
+      {
+         if (other_node != node)
+         {
+            adjacent_nodes.push_back(other_node);
+         }
+      }
+   }
+
+   return adjacent_nodes;
+}
+
+template <typename T>
+std::vector<typename compact_view<T>::index_type>
+compact_view<T>::get_adjacent_edges(index_type edge) const
+{
+   std::vector<index_type> adjacent_edges;
+
+   for (index_type node : get_incident_nodes(edge))
+   {
+      for (index_type other_edge : get_incident_edges(node))
+      {
+         if (other_edge != edge)
+         {
+            adjacent_edges.push_back(other_edge);
+         }
+      }
+   }
+
+   return adjacent_edges;
+}
+
+template <typename T>
+bool compact_view<T>::is_incident_to(index_type node, index_type edge) const
+{
+   if (node >= node_count() || edge >= edge_count())
+   {
+      return false;
+   }
+
+   std::span<const index_type> incident_edges = get_incident_edges(node);
+   return std::binary_search(incident_edges.begin(), incident_edges.end(), edge);
+}
+
+template <typename T>
+bool compact_view<T>::is_adjacent_to(index_type node, index_type other_node) const
+{
+   if (node >= node_count() || other_node >= node_count())
+   {
+      return false;
+   }
+
+   for (index_type edge : get_incident_edges(node))
+   {
+      if (is_incident_to(other_node, edge))
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+} // namespace ctl
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <ctl/internal/epoch_domain.hpp>
+#include <ctl/internal/threading.hpp>
+#include <ctl/versioned_hypergraph.hpp>
+
+namespace ctl
+{
+// A versioned_hypergraph shared between one writer and many concurrent readers. The writer edits
+// a private working copy and publishes it as an immutable snapshot, which takes O(1) thanks to
+// the copy-on-write chunks, and readers pin the latest published snapshot without taking any
+// lock. A snapshot replaced by a newer one is retired and freed once no reader can still be
+// inside it (epoch-based reclamation), which also releases the chunks only it was holding on to.
+//
+//    concurrent_hypergraph<T> graph;
+//    // writer thread
+//    graph.edit().add_edge({a, b});
+//    graph.publish();
+//    // reader thread, one reader per thread
+//    auto reader = graph.make_reader();
+//    auto view   = reader.pin();
+//    view->get_incident_edges(a);
+template <typename T>
+class concurrent_hypergraph
+{
+   static_assert(!internal::single_threaded,
+                 "concurrent_hypergraph cannot be used when CTL_SINGLE_THREADED is defined to 1.");
+
+ public:
+   // keeps a snapshot alive for as long as it exists. Pinning is not reentrant: a reader has at
+   // most one guard at a time.
+   class read_guard
+   {
+    public:
+      read_guard(const read_guard&)            = delete;
+      read_guard& operator=(const read_guard&) = delete;
+      read_guard(read_guard&& rhs) noexcept
+         : domain_(std::exchange(rhs.domain_, nullptr)), slot_(rhs.slot_),
+           snapshot_(rhs.snapshot_)
+      {
+      }
+      read_guard& operator=(read_guard&&) = delete;
+
+      ~read_guard()
+      {
+         if (domain_ != nullptr)
+         {
+            domain_->leave(slot_);
+         }
+      }
+
+      const versioned_hypergraph<T>& operator*() const { return *snapshot_; }
+      const versioned_hypergraph<T>* operator->() const { return snapshot_; }
+
+    private:
+      friend class concurrent_hypergraph;
+
+      read_guard(internal::epoch_domain* domain, size_t slot,
+                 const versioned_hypergraph<T>* snapshot)
+         : domain_(domain), slot_(slot), snapshot_(snapshot)
+      {
+      }
+
+      internal::epoch_domain* domain_;
+      size_t slot_;
+      const versioned_hypergraph<T>* snapshot_;
+   };
+
+   // a registered reader, to be used by a single thread
+   class reader
+   {
+    public:
+      reader(const reader&)            = delete;
+      reader& operator=(const reader&) = delete;
+      reader(reader&& rhs) noexcept
+         : graph_(std::exchange(rhs.graph_, nullptr)), slot_(rhs.slot_)
+      {
+      }
+      reader& operator=(reader&&) = delete;
+
+      ~reader()
+      {
+         if (graph_ != nullptr)
+         {
+            graph_->domain_.release_slot(slot_);
+         }
+      }
+
+      read_guard pin() const
+      {
+         graph_->domain_.enter(slot_);
+         return read_guard(&graph_->domain_, slot_,
+                           graph_->published_.load(std::memory_order_seq_cst));
+      }
+
+    private:
+      friend class concurrent_hypergraph;
+
+      reader(const concurrent_hypergraph* graph, size_t slot) : graph_(graph), slot_(slot) {}
+
+      const concurrent_hypergraph* graph_;
+      size_t slot_;
+   };
+
+   explicit concurrent_hypergraph(versioned_hypergraph<T> initial = {}, size_t max_readers = 64);
+   concurrent_hypergraph(const concurrent_hypergraph&)            = delete;
+   concurrent_hypergraph& operator=(const concurrent_hypergraph&) = delete;
+
+   // all readers must have been destroyed
+   ~concurrent_hypergraph();
+
+   // writer side: the working copy, invisible to readers until published
+   versioned_hypergraph<T>& edit() { return working_; }
+
+   // makes the working copy the snapshot new pins see and reclaims what readers no longer use
+   void publish();
+
+   // frees the retired snapshots no reader is inside anymore and returns how many remain
+   size_t collect();
+
+   size_t retired_count() const { return retired_.size(); }
+
+   // registers a reader, throwing std::length_error if max_readers readers exist already
+   reader make_reader() const { return reader(this, domain_.acquire_slot()); }
+
+ private:
+   struct retired_snapshot
+   {
+      uint64_t epoch;
+      std::unique_ptr<const versioned_hypergraph<T>> snapshot;
+   };
+
+   versioned_hypergraph<T> working_;
+   std::atomic<const versioned_hypergraph<T>*> published_;
+   std::vector<retired_snapshot> retired_;
+   mutable internal::epoch_domain domain_;
+};
+
+template <typename T>
+concurrent_hypergraph<T>::concurrent_hypergraph(versioned_hypergraph<T> initial,
+                                                size_t max_readers)
+   : working_(std::move(initial)), published_(new versioned_hypergraph<T>(working_.snapshot())),
+     domain_(max_readers)
+{
+}
+
+template <typename T>
+concurrent_hypergraph<T>::~concurrent_hypergraph()
+{
+   delete published_.load();
+}
+
+template <typename T>
+void concurrent_hypergraph<T>::publish()
+{
+   auto* snapshot = new versioned_hypergraph<T>(working_.snapshot());
+   const versioned_hypergraph<T>* previous = published_.exchange(snapshot);
+
+   // readers entering from here on load the new snapshot, the ones that might still be using the
+   // previous one entered no later than the epoch ending now
+   retired_.push_back(retired_snapshot{
+      domain_.advance(), std::unique_ptr<const versioned_hypergraph<T>>(previous)});
+   collect();
+}
+
+template <typename T>
+size_t concurrent_hypergraph<T>::collect()
+{
+   const uint64_t oldest = domain_.min_active();
+
+   std::erase_if(retired_, [oldest](const retired_snapshot& retired)
+   {
+      return retired.epoch < oldest;
+   });
+
+   return retired_.size();
+}
+} // namespace ctl
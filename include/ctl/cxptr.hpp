@@ -2,49 +2,91 @@
 
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <ctl/instrumentation.hpp>
+#include <ctl/internal/threading.hpp>
 
 namespace ctl
 {
+// A strong reference that keeps its object alive for its whole scope, obtained from
+// cxptr::pin(). The object is locked once, every later access is a plain pointer dereference.
+template <typename T>
+class pinned {
+public:
+    explicit pinned(std::shared_ptr<T> object) noexcept : object_(std::move(object)) {}
+
+    pinned(const pinned&) = delete;
+    pinned& operator=(const pinned&) = delete;
+    pinned(pinned&&) noexcept = default;
+    pinned& operator=(pinned&&) noexcept = default;
+
+    T& get() const { return *object_; }
+    T* operator->() const { return object_.get(); }
+    T& operator*() const { return *object_; }
+
+private:
+    std::shared_ptr<T> object_;
+};
+
 template <typename T>
 class cxptr : public std::weak_ptr<T> {
 public:
 
-    using std::weak_ptr<T>::weak_ptr;
+    cxptr() noexcept = default;
+
+    template <typename Y>
+        requires std::is_convertible_v<Y*, T*>
+    cxptr(const std::shared_ptr<Y>& object) noexcept : std::weak_ptr<T>(object) {
+        cache(object.get());
+    }
+
+    template <typename Y>
+        requires std::is_convertible_v<Y*, T*>
+    cxptr(const std::weak_ptr<Y>& object) noexcept : std::weak_ptr<T>(object) {
+        if constexpr (internal::single_threaded) {
+            cache(std::weak_ptr<T>::lock().get());
+        }
+    }
+
+    // Lock the managed object, counted when instrumentation is enabled
+    std::shared_ptr<T> lock() const {
+        internal::count_event(internal::instrumented_counter::pointer_locks);
+        return std::weak_ptr<T>::lock();
+    }
 
     // Check if the managed object is still alive
     bool is_valid() const {
         return !this->expired();
     }
 
-    // Access the managed object, throws if it no longer exists
-    T& get() {
+    // Keep the managed object alive for the scope of the returned reference, throws if it no
+    // longer exists. Use it to access an object many times with a single lock.
+    pinned<T> pin() const {
         if (auto sp = this->lock()) {
-            return *sp;
+            return pinned<T>(std::move(sp));
         }
         throw std::runtime_error("The object pointed to by the weak_ptr no longer exists.");
     }
 
+    // Access the managed object, throws if it no longer exists
+    T& get() {
+        return *checked_pointer();
+    }
+
     // Access the managed object with a const reference
     const T& get() const {
-        if (auto sp = this->lock()) {
-            return *sp;
-        }
-        throw std::runtime_error("The object pointed to by the weak_ptr no longer exists.");
+        return *checked_pointer();
     }
 
     // Operator overloading for easier access
     T* operator->() {
-        if (auto sp = this->lock()) {
-            return sp.get();
-        }
-        throw std::runtime_error("The object pointed to by the weak_ptr no longer exists.");
+        return checked_pointer();
     }
 
     const T* operator->() const {
-        if (auto sp = this->lock()) {
-            return sp.get();
-        }
-        throw std::runtime_error("The object pointed to by the weak_ptr no longer exists.");
+        return checked_pointer();
     }
 
     // Operator overloading for dereferencing
@@ -64,5 +106,39 @@ public:
     operator std::shared_ptr<T>() const {
         return this->lock();
     }
+
+    // Reset and swap keep the cached pointer of the single-threaded mode in step
+    void reset() noexcept {
+        std::weak_ptr<T>::reset();
+        cache(nullptr);
+    }
+
+    void swap(cxptr& rhs) noexcept {
+        std::weak_ptr<T>::swap(rhs);
+        std::swap(object_, rhs.object_);
+    }
+
+private:
+    // Without other threads nothing can destroy the object between the check and the access, so
+    // the single-threaded mode skips the two atomic updates of a lock
+    T* checked_pointer() const {
+        if constexpr (internal::single_threaded) {
+            if (!this->expired()) {
+                return object_;
+            }
+        } else if (auto sp = this->lock()) {
+            return sp.get();
+        }
+        throw std::runtime_error("The object pointed to by the weak_ptr no longer exists.");
+    }
+
+    void cache([[maybe_unused]] T* object) noexcept {
+        if constexpr (internal::single_threaded) {
+            object_ = object;
+        }
+    }
+
+    [[no_unique_address]] std::conditional_t<internal::single_threaded, T*, internal::no_pointer>
+        object_{};
 };
 } // namespace cnr
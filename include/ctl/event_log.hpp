@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace ctl
+{
+// The causal graph of a sequence of rewriting events: there is one edge from event a to event b
+// for every hyperedge produced by a and consumed by b, so the graph may contain parallel edges.
+// Both directions are stored in CSR form.
+class causal_graph
+{
+ public:
+   size_t event_count() const { return effect_offsets_.size() - 1; }
+   size_t edge_count() const { return effects_.size(); }
+
+   // the events that consumed an edge produced by event
+   std::span<const uint32_t> get_effects(size_t event) const
+   {
+      return slice(effect_offsets_, effects_, event);
+   }
+
+   // the events that produced an edge consumed by event. Edges of the initial state have no
+   // producing event and do not appear here.
+   std::span<const uint32_t> get_causes(size_t event) const
+   {
+      return slice(cause_offsets_, causes_, event);
+   }
+
+ private:
+   template <typename Id>
+   friend class event_log;
+
+   static std::span<const uint32_t> slice(const std::vector<size_t>& offsets,
+                                          const std::vector<uint32_t>& values, size_t event)
+   {
+      if (event + 1 >= offsets.size())
+      {
+         throw std::out_of_range("Event index is out of range of the causal graph.");
+      }
+
+      return std::span<const uint32_t>(values.data() + offsets[event],
+                                        offsets[event + 1] - offsets[event]);
+   }
+
+   std::vector<size_t> effect_offsets_{0};
+   std::vector<uint32_t> effects_;
+   std::vector<size_t> cause_offsets_{0};
+   std::vector<uint32_t> causes_;
+};
+
+// An append-only record of the edges consumed and produced by every rewriting event. Only edge
+// ids are kept, in two flat arrays with per-event offsets, so the log never holds on to removed
+// hyperedge objects and costs a few words per edge.
+template <typename Id>
+class event_log
+{
+ public:
+   using id_type = Id;
+
+   template <typename Consumed, typename Produced>
+   void record(const Consumed& consumed, const Produced& produced)
+   {
+      consumed_.insert(consumed_.end(), std::begin(consumed), std::end(consumed));
+      consumed_offsets_.push_back(consumed_.size());
+      produced_.insert(produced_.end(), std::begin(produced), std::end(produced));
+      produced_offsets_.push_back(produced_.size());
+   }
+
+   size_t event_count() const { return consumed_offsets_.size() - 1; }
+
+   std::span<const id_type> get_consumed(size_t event) const
+   {
+      return std::span<const id_type>(consumed_.data() + consumed_offsets_.at(event),
+                                      consumed_offsets_.at(event + 1) - consumed_offsets_[event]);
+   }
+
+   std::span<const id_type> get_produced(size_t event) const
+   {
+      return std::span<const id_type>(produced_.data() + produced_offsets_.at(event),
+                                      produced_offsets_.at(event + 1) - produced_offsets_[event]);
+   }
+
+   // derives the causal graph. Every edge is consumed at most once, so the producer of an edge is
+   // forgotten as soon as its consumer is found and the lookup table only holds live edges.
+   causal_graph build_causal_graph() const
+   {
+      const size_t events = event_count();
+      std::unordered_map<id_type, uint32_t> producers;
+      std::vector<uint32_t> sources;
+      std::vector<uint32_t> targets;
+
+      for (size_t event = 0; event < events; ++event)
+      {
+         for (const id_type& edge : get_consumed(event))
+         {
+            auto producer = producers.find(edge);
+
+            if (producer != producers.end())
+            {
+               sources.push_back(producer->second);
+               targets.push_back(static_cast<uint32_t>(event));
+               producers.erase(producer);
+            }
+         }
+
+         for (const id_type& edge : get_produced(event))
+         {
+            producers.emplace(edge, static_cast<uint32_t>(event));
+         }
+      }
+
+      causal_graph graph;
+      fill(graph.effect_offsets_, graph.effects_, sources, targets, events);
+      fill(graph.cause_offsets_, graph.causes_, targets, sources, events);
+      return graph;
+   }
+
+   void reserve(size_t events, size_t edges_per_event)
+   {
+      consumed_offsets_.reserve(events + 1);
+      produced_offsets_.reserve(events + 1);
+      consumed_.reserve(events * edges_per_event);
+      produced_.reserve(events * edges_per_event);
+   }
+
+   void clear()
+   {
+      consumed_.clear();
+      produced_.clear();
+      consumed_offsets_.assign(1, 0);
+      produced_offsets_.assign(1, 0);
+   }
+
+ private:
+   // counting sort of the pairs (from[i], to[i]) by from
+   static void fill(std::vector<size_t>& offsets, std::vector<uint32_t>& values,
+                    const std::vector<uint32_t>& from, const std::vector<uint32_t>& to,
+                    size_t events)
+   {
+      offsets.assign(events + 1, 0);
+
+      for (uint32_t event : from)
+      {
+         ++offsets[event + 1];
+      }
+
+      for (size_t event = 0; event < events; ++event)
+      {
+         offsets[event + 1] += offsets[event];
+      }
+
+      std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+      values.resize(from.size());
+
+      for (size_t i = 0; i < from.size(); ++i)
+      {
+         values[cursor[from[i]]++] = to[i];
+      }
+   }
+
+   std::vector<id_type> consumed_;
+   std::vector<size_t> consumed_offsets_{0};
+   std::vector<id_type> produced_;
+   std::vector<size_t> produced_offsets_{0};
+};
+} // namespace ctl
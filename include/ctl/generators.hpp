@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <ctl/hypergraph.hpp>
+#include <ctl/hypergraph_builder.hpp>
+#include <ctl/internal/random.hpp>
+#include <ctl/internal/thread_pool.hpp>
+
+namespace ctl
+{
+// Synthetic hypergraphs for benchmarks and load tests, created with default constructed nodes
+// through hypergraph_builder. Edges are drawn in fixed blocks, each from its own random stream
+// derived from the seed, so the same seed gives the same hypergraph on every platform and for
+// every thread count.
+struct generator_options
+{
+   std::uint64_t seed  = 0;
+   size_t thread_count = 1;
+};
+
+// edge_count edges of arity distinct nodes each, drawn uniformly from node_count nodes
+template <typename T>
+typename hypergraph_builder<T>::result generate_uniform(hypergraph<T>& graph, size_t node_count,
+                                                        size_t edge_count, size_t arity,
+                                                        const generator_options& options = {});
+
+// edge_count edges of arity distinct nodes each, where node i is drawn with a weight of
+// (i + 1)^(-1 / (exponent - 1)), so the expected degrees follow a power law with the given
+// exponent, as in the Chung-Lu model. The nodes of an edge are drawn one after another from the
+// nodes not in it yet. Node 0 has the highest expected degree.
+template <typename T>
+typename hypergraph_builder<T>::result generate_chung_lu(hypergraph<T>& graph, size_t node_count,
+                                                         size_t edge_count, size_t arity,
+                                                         double exponent,
+                                                         const generator_options& options = {});
+
+// node_count nodes split into community_count contiguous communities of nearly equal size, and
+// edge_count edges of arity distinct nodes each. With intra_probability an edge draws all of its
+// nodes from one community chosen uniformly, otherwise from all nodes.
+template <typename T>
+typename hypergraph_builder<T>::result
+generate_planted_partition(hypergraph<T>& graph, size_t node_count, size_t edge_count,
+                           size_t arity, size_t community_count, double intra_probability,
+                           const generator_options& options = {});
+
+// a grid with the given extent in every dimension, whose nodes are numbered in row-major order.
+// Every unit cell becomes an edge of its 2^d corners, in the order of their offsets read as
+// binary numbers with the first dimension as the highest bit. If periodic, the grid wraps around
+// in every dimension, which needs extents of at least 3.
+template <typename T>
+typename hypergraph_builder<T>::result generate_lattice(hypergraph<T>& graph,
+                                                        std::span<const size_t> extents,
+                                                        bool periodic = false,
+                                                        size_t thread_count = 1);
+
+namespace internal
+{
+inline constexpr size_t generator_block_size = 4096;
+
+// the pins of edge_count edges of arity nodes each, where fill(stream, edge, pins, scratch) fills
+// the pins of one edge. scratch is a buffer with room for arity values that every thread reuses
+// for all of its edges, so drawing an edge needs no allocation.
+template <typename Fill>
+std::vector<std::uint32_t> generate_pins(size_t edge_count, size_t arity,
+                                         const generator_options& options, Fill&& fill)
+{
+   if (arity != 0 && edge_count > SIZE_MAX / arity)
+   {
+      throw std::length_error("Too many pins to generate.");
+   }
+
+   std::vector<std::uint32_t> pins(edge_count * arity);
+   const size_t block_count = (edge_count + generator_block_size - 1) / generator_block_size;
+
+   thread_pool(options.thread_count).parallel_for(block_count, [&](size_t begin, size_t end)
+   {
+      std::vector<std::uint32_t> scratch;
+      scratch.reserve(arity);
+
+      for (size_t block = begin; block < end; ++block)
+      {
+         random_stream stream(options.seed, block);
+         const size_t last = std::min(edge_count, (block + 1) * generator_block_size);
+
+         for (size_t edge = block * generator_block_size; edge < last; ++edge)
+         {
+            fill(stream, edge, std::span<std::uint32_t>(pins.data() + edge * arity, arity),
+                 scratch);
+         }
+      }
+   });
+
+   return pins;
+}
+
+// draws nodes until every pin holds a node that no earlier pin holds
+template <typename Draw>
+void draw_distinct(std::span<std::uint32_t> pins, Draw&& draw)
+{
+   for (size_t pin = 0; pin < pins.size(); ++pin)
+   {
+      do
+      {
+         pins[pin] = draw();
+      } while (std::find(pins.begin(), pins.begin() + pin, pins[pin]) != pins.begin() + pin);
+   }
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result build_generated(hypergraph<T>& graph, size_t node_count,
+                                                       size_t edge_count, size_t arity,
+                                                       const std::vector<std::uint32_t>& pins,
+                                                       size_t thread_count)
+{
+   std::vector<size_t> offsets(edge_count + 1);
+
+   for (size_t edge = 0; edge <= edge_count; ++edge)
+   {
+      offsets[edge] = edge * arity;
+   }
+
+   hypergraph_builder<T> builder;
+   builder.reserve(node_count, edge_count, pins.size());
+   builder.add_nodes(node_count);
+   builder.add_edges(offsets, pins);
+   return builder.build(graph, thread_count);
+}
+
+inline void check_generator_arguments(size_t node_count, size_t arity)
+{
+   if (node_count >= UINT32_MAX)
+   {
+      throw std::length_error("Too many nodes to generate.");
+   }
+
+   if (arity > node_count)
+   {
+      throw std::invalid_argument("Edges cannot have more distinct nodes than the hypergraph.");
+   }
+}
+} // namespace internal
+
+template <typename T>
+typename hypergraph_builder<T>::result generate_uniform(hypergraph<T>& graph, size_t node_count,
+                                                        size_t edge_count, size_t arity,
+                                                        const generator_options& options)
+{
+   internal::check_generator_arguments(node_count, arity);
+   const std::uint32_t bound = static_cast<std::uint32_t>(node_count);
+
+   std::vector<std::uint32_t> pins = internal::generate_pins(
+      edge_count, arity, options,
+      [bound](internal::random_stream& stream, size_t, std::span<std::uint32_t> edge,
+              std::vector<std::uint32_t>&)
+   { internal::draw_distinct(edge, [&stream, bound] { return stream.below(bound); }); });
+
+   return internal::build_generated(graph, node_count, edge_count, arity, pins,
+                                    options.thread_count);
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result generate_chung_lu(hypergraph<T>& graph, size_t node_count,
+                                                         size_t edge_count, size_t arity,
+                                                         double exponent,
+                                                         const generator_options& options)
+{
+   internal::check_generator_arguments(node_count, arity);
+
+   if (!(exponent > 1.0))
+   {
+      throw std::invalid_argument("The degree exponent has to be greater than 1.");
+   }
+
+   // node i is drawn when a uniform value falls below cumulative[i] but not cumulative[i - 1]
+   std::vector<double> weights(node_count);
+   std::vector<double> cumulative(node_count);
+   double total = 0.0;
+
+   for (size_t node = 0; node < node_count; ++node)
+   {
+      weights[node] = std::pow(static_cast<double>(node + 1), -1.0 / (exponent - 1.0));
+      total += weights[node];
+      cumulative[node] = total;
+   }
+
+   // The nodes of an edge are drawn without replacement, each in proportion to its weight among
+   // the nodes not drawn yet. Rejecting repeats instead never ends when the nodes left have next
+   // to no weight, as with an exponent close to 1. The weights of the drawn nodes are skipped by
+   // moving the target past them, and where rounding leaves nothing to draw from, the heaviest
+   // node not drawn yet is taken.
+   std::vector<std::uint32_t> pins = internal::generate_pins(
+      edge_count, arity, options,
+      [&](internal::random_stream& stream, size_t, std::span<std::uint32_t> edge,
+          std::vector<std::uint32_t>& drawn)
+   {
+      // the nodes drawn so far, in increasing order
+      drawn.clear();
+      double remaining = total;
+
+      auto find = [&cumulative](double target)
+      {
+         return static_cast<size_t>(
+            std::upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin());
+      };
+
+      for (std::uint32_t& pin : edge)
+      {
+         double target = stream.unit() * remaining;
+         size_t node   = find(target);
+
+         for (std::uint32_t previous : drawn)
+         {
+            if (previous > node)
+            {
+               break;
+            }
+
+            target += weights[previous];
+            node = find(target);
+         }
+
+         if (node >= node_count || std::binary_search(drawn.begin(), drawn.end(), node))
+         {
+            node = 0;
+
+            while (node < drawn.size() && drawn[node] == node)
+            {
+               ++node;
+            }
+         }
+
+         pin = static_cast<std::uint32_t>(node);
+         drawn.insert(std::upper_bound(drawn.begin(), drawn.end(), pin), pin);
+         remaining = std::max(remaining - weights[node], 0.0);
+      }
+   });
+
+   return internal::build_generated(graph, node_count, edge_count, arity, pins,
+                                    options.thread_count);
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result
+generate_planted_partition(hypergraph<T>& graph, size_t node_count, size_t edge_count,
+                           size_t arity, size_t community_count, double intra_probability,
+                           const generator_options& options)
+{
+   internal::check_generator_arguments(node_count, arity);
+
+   if (community_count == 0 || community_count > node_count)
+   {
+      throw std::invalid_argument("There has to be at least one node in every community.");
+   }
+
+   if (!(intra_probability >= 0.0 && intra_probability <= 1.0))
+   {
+      throw std::invalid_argument("The probability of an edge within a community is invalid.");
+   }
+
+   if (intra_probability > 0.0 && arity > node_count / community_count)
+   {
+      throw std::invalid_argument("Edges cannot have more distinct nodes than a community.");
+   }
+
+   std::vector<std::uint32_t> pins = internal::generate_pins(
+      edge_count, arity, options,
+      [&](internal::random_stream& stream, size_t, std::span<std::uint32_t> edge,
+          std::vector<std::uint32_t>&)
+   {
+      std::uint64_t first = 0;
+      std::uint32_t size  = static_cast<std::uint32_t>(node_count);
+
+      if (stream.unit() < intra_probability)
+      {
+         const std::uint64_t community = stream.below(static_cast<std::uint32_t>(community_count));
+         first = community * node_count / community_count;
+         size  = static_cast<std::uint32_t>((community + 1) * node_count / community_count - first);
+      }
+
+      internal::draw_distinct(edge, [&stream, first, size]
+      { return static_cast<std::uint32_t>(first + stream.below(size)); });
+   });
+
+   return internal::build_generated(graph, node_count, edge_count, arity, pins,
+                                    options.thread_count);
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result generate_lattice(hypergraph<T>& graph,
+                                                        std::span<const size_t> extents,
+                                                        bool periodic, size_t thread_count)
+{
+   if (extents.empty() || extents.size() > 16)
+   {
+      throw std::invalid_argument("A lattice needs between 1 and 16 dimensions.");
+   }
+
+   // strides of the nodes and of the unit cells in row-major order
+   const size_t dimensions = extents.size();
+   std::vector<size_t> node_strides(dimensions);
+   std::vector<size_t> cell_extents(dimensions);
+   size_t node_count = 1;
+   size_t cell_count = 1;
+
+   for (size_t dimension = dimensions; dimension-- > 0;)
+   {
+      const size_t extent = extents[dimension];
+
+      if (extent == 0 || (periodic && extent < 3))
+      {
+         throw std::invalid_argument("The extents of the lattice are too small.");
+      }
+
+      if (node_count > UINT32_MAX / extent)
+      {
+         throw std::length_error("Too many nodes to generate.");
+      }
+
+      node_strides[dimension] = node_count;
+      cell_extents[dimension] = periodic ? extent : extent - 1;
+      node_count *= extent;
+      cell_count *= cell_extents[dimension];
+   }
+
+   const size_t arity = size_t{1} << dimensions;
+   internal::check_generator_arguments(node_count, 0);
+
+   std::vector<std::uint32_t> pins = internal::generate_pins(
+      cell_count, arity, generator_options{0, thread_count},
+      [&](internal::random_stream&, size_t cell, std::span<std::uint32_t> edge,
+          std::vector<std::uint32_t>&)
+   {
+      // the coordinates of the cell's first corner, from the last dimension up
+      std::array<size_t, 16> corner{};
+
+      for (size_t dimension = dimensions; dimension-- > 0;)
+      {
+         corner[dimension] = cell % cell_extents[dimension];
+         cell /= cell_extents[dimension];
+      }
+
+      for (size_t offset = 0; offset < arity; ++offset)
+      {
+         size_t node = 0;
+
+         for (size_t dimension = 0; dimension < dimensions; ++dimension)
+         {
+            const size_t step = (offset >> (dimensions - 1 - dimension)) & 1;
+            node += (corner[dimension] + step) % extents[dimension] * node_strides[dimension];
+         }
+
+         edge[offset] = static_cast<std::uint32_t>(node);
+      }
+   });
+
+   return internal::build_generated(graph, node_count, cell_count, arity, pins, thread_count);
+}
+} // namespace ctl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace ctl
+{
+// A stable reference to a node (handle<T>) or edge (handle<hyperedge<T>>) of a hypergraph. The
+// index addresses a slot in the hypergraph's storage and the generation is bumped whenever that
+// slot is vacated, so a handle to a removed element never resolves to whatever reuses its slot.
+// Resolving a handle is O(1) and, unlike cxptr, does not touch any reference counts.
+template <typename T>
+struct handle
+{
+   static constexpr std::uint32_t null_index = UINT32_MAX;
+
+   std::uint32_t index      = null_index;
+   std::uint32_t generation = 0;
+
+   bool is_null() const { return index == null_index; }
+
+   bool operator==(const handle& rhs) const = default;
+};
+} // namespace ctl
+
+template <typename T>
+struct std::hash<ctl::handle<T>>
+{
+   size_t operator()(const ctl::handle<T>& value) const noexcept
+   {
+      return std::hash<std::uint64_t>()((static_cast<std::uint64_t>(value.generation) << 32) |
+                                        value.index);
+   }
+};
@@ -1,17 +1,63 @@
 #pragma once
 
 #include <memory>
+#include <ranges>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <ctl/compact_view.hpp>
 #include <ctl/cxptr.hpp>
+#include <ctl/handle.hpp>
+#include <ctl/identity_policy.hpp>
+#include <ctl/instrumentation.hpp>
 #include <ctl/internal/identity.hpp>
+#include <ctl/internal/slab_pool.hpp>
+#include <ctl/internal/slot_map.hpp>
 #include <ctl/internal/utility.hpp>
 
 namespace ctl
 {
-template <typename T>
+// Selects where a hypergraph allocates its nodes and edges. heap uses one global allocation per
+// element, pooled carves them from chunks owned by the hypergraph and recycles removed slots.
+enum class storage_mode
+{
+   heap,
+   pooled
+};
+
+// Whether removing nodes in bulk also removes the edges that are left without any node.
+enum class empty_edges
+{
+   keep,
+   remove
+};
+
+// The bytes a hypergraph holds, by what they are spent on. Control blocks are estimated from the
+// layout of the common standard libraries. The pooled storage mode allocates nodes, edges and
+// their control blocks from chunks, whose size is reported separately and not part of the total.
+// Removed elements that are still referenced by a cxptr are not counted, although their memory
+// is only freed once the last cxptr is gone.
+struct memory_footprint
+{
+   size_t node_bytes            = 0;
+   size_t edge_bytes            = 0;
+   size_t control_block_bytes   = 0;
+   size_t incidence_bytes       = 0;
+   size_t incidence_slack_bytes = 0;
+   size_t index_bytes           = 0;
+   size_t undo_log_bytes        = 0;
+   size_t pool_reserved_bytes   = 0;
+
+   size_t total() const
+   {
+      return node_bytes + edge_bytes + control_block_bytes + incidence_bytes +
+             incidence_slack_bytes + index_bytes + undo_log_bytes;
+   }
+};
+
+template <typename T, typename IdentityPolicy = monotonic_identity>
 class node;
 
 template <typename T>
@@ -21,7 +67,29 @@ template <typename T>
 class hypergraph;
 
 template <typename T>
-class node : public internal::identity
+class versioned_hypergraph;
+
+template <typename T>
+class hypergraph_builder;
+
+// Receives notifications about structural changes of the hypergraph it is attached to.
+// on_edge_removed is called while the edge is still linked to its nodes and on_edge_added once it
+// has been linked. Removing nodes, one or many at once, reports every edge they belonged to as
+// removed and, once all of them have been changed, as re-added, so a structure spanning several
+// of them is seen from each. Rolling back a node removal announces the restored edges the same way.
+// Changes made directly through hyperedge<T>::add_node(s)/remove_node(s) are not reported.
+template <typename T>
+class hypergraph_observer
+{
+ public:
+   virtual ~hypergraph_observer() = default;
+
+   virtual void on_edge_added(const hyperedge<T>& edge)   = 0;
+   virtual void on_edge_removed(const hyperedge<T>& edge) = 0;
+};
+
+template <typename T, typename IdentityPolicy>
+class node : public internal::identity<IdentityPolicy>
 {
    template <typename U>
    friend class hyperedge;
@@ -29,7 +97,15 @@ class node : public internal::identity
    template <typename U>
    friend class hypergraph;
 
+   template <typename U>
+   friend class versioned_hypergraph;
+
+   template <typename U>
+   friend class hypergraph_builder;
+
  public:
+    using identity_policy = IdentityPolicy;
+
     node();
     node(const node&) = default;
     node& operator=(const node&) = default;
@@ -37,9 +113,22 @@ class node : public internal::identity
     node& operator=(node&&) noexcept = default;
     ~node() = default;
 
+   handle<T> get_handle() const { return handle_; }
+
    std::vector<cxptr<hyperedge<T>>> get_incident_edges() const;
    std::vector<cxptr<T>> get_adjacent_nodes() const;
 
+   // lazy counterparts of the queries above. They yield references to the incident edges and
+   // adjacent nodes straight from the incidence lists and are invalidated by structural changes.
+   auto incident_edges() const;
+   auto adjacent_nodes() const;
+
+   // like get_adjacent_nodes, but every neighbour is reported once no matter how many edges it
+   // shares with this node. Both use visited marks stored on the nodes and edges, so they must not
+   // run concurrently with other traversals of the same neighbourhood.
+   std::vector<cxptr<T>> get_unique_adjacent_nodes() const;
+   size_t count_adjacent_nodes() const;
+
    bool is_incident_to(const cxptr<hyperedge<T>>& edge) const;
    bool is_adjacent_to(const cxptr<T>& vertex) const;
 
@@ -51,18 +140,30 @@ class node : public internal::identity
    //void remove_incident_edge(const cxptr<hyperedge<T>>& incident_edge);
 
  private:
+   template <typename Visitor>
+   void visit_unique_adjacent_nodes(Visitor&& visitor) const;
+
    std::vector<std::shared_ptr<hyperedge<T>>> incident_edges_;
+   handle<T> handle_;
+   mutable std::uint64_t visit_epoch_ = 0;
 };
 
 template <typename T>
-class hyperedge : public internal::identity, public std::enable_shared_from_this<hyperedge<T>>
+class hyperedge : public internal::identity<typename T::identity_policy>,
+                  public std::enable_shared_from_this<hyperedge<T>>
 {
-   template <typename U>
+   template <typename U, typename P>
    friend class node;
 
    template <typename U>
    friend class hypergraph;
 
+   template <typename U>
+   friend class compact_view;
+
+   template <typename U>
+   friend class hypergraph_builder;
+
  public:
    hyperedge();
    hyperedge(const std::vector<std::shared_ptr<T>>& nodes);
@@ -80,9 +181,20 @@ class hyperedge : public internal::identity, public std::enable_shared_from_this
    void add_nodes(std::vector<cxptr<T>> nodes, size_t insertion_point);
    void remove_nodes(size_t from_index, size_t to_index);
 
+   handle<hyperedge<T>> get_handle() const { return handle_; }
+
    std::vector<cxptr<T>> get_incident_nodes() const;
    std::vector<cxptr<hyperedge<T>>> get_adjacent_edges() const;
 
+   // lazy counterparts of the queries above, see node<T>::incident_edges
+   auto incident_nodes() const;
+   auto adjacent_edges() const;
+
+   // like get_adjacent_edges, but every neighbour is reported once, see
+   // node<T>::get_unique_adjacent_nodes
+   std::vector<cxptr<hyperedge<T>>> get_unique_adjacent_edges() const;
+   size_t count_adjacent_edges() const;
+
    bool is_incident_to(const cxptr<T>& node) const;
    bool is_adjacent_to(const cxptr<hyperedge<T>>& edge) const;
 
@@ -93,64 +205,206 @@ class hyperedge : public internal::identity, public std::enable_shared_from_this
    const std::vector<std::shared_ptr<T>>::iterator find_node(cxptr<T> node);
 
  private:
+   template <typename Visitor>
+   void visit_unique_adjacent_edges(Visitor&& visitor) const;
+
    std::vector<std::shared_ptr<T>> incident_nodes_;
+   handle<hyperedge<T>> handle_;
+   mutable std::uint64_t visit_epoch_ = 0;
 };
 
 template <typename T>
-class hypergraph : public internal::identity
+class hypergraph : public internal::identity<typename T::identity_policy>
 {
-   template <typename U>
+   template <typename U, typename P>
    friend class node;
 
    template <typename U>
    friend class hyperedge;
 
+   template <typename U>
+   friend class compact_view;
+
+   template <typename U>
+   friend class rewriter;
+
+   template <typename U>
+   friend class versioned_hypergraph;
+
+   template <typename U>
+   friend class hypergraph_builder;
+
  public:
    hypergraph();
-   hypergraph(const hypergraph&) = default;
-   hypergraph& operator=(const hypergraph&) = default;
-   hypergraph(hypergraph&&) = default;
-   hypergraph& operator=(hypergraph&&) = default;
-   virtual ~hypergraph() = default;
+   explicit hypergraph(storage_mode mode);
+
+   // copies are deep: the copy gets its own nodes and edges, with the same ids and handles as the
+   // originals, and a new id of its own. This costs O(V + E), see versioned_hypergraph<T> for
+   // O(1) snapshots.
+   hypergraph(const hypergraph& rhs);
+   hypergraph& operator=(const hypergraph& rhs);
+   // a moved-from hypergraph is empty and stores its elements on the heap
+   hypergraph(hypergraph&& rhs) noexcept;
+   hypergraph& operator=(hypergraph&& rhs);
+   virtual ~hypergraph();
+
+   storage_mode get_storage_mode() const { return mode_; }
 
    template <typename... Args>
    cxptr<T> add_node(Args&&... args);
    cxptr<T> add_node(T&& node);
    void remove_node(const cxptr<T>& node);
+   void remove_node(handle<T> node);
 
    std::vector<cxptr<T>> add_nodes(const size_t count);
-   void remove_nodes(const std::vector<cxptr<T>>& nodes);
+
+   // removes a batch of nodes in one pass: the nodes are marked, every edge containing one of
+   // them is compacted once and the incidence lists of the removed nodes are dropped, so the cost
+   // is linear in the degrees of the nodes and the sizes of their edges, however large the batch.
+   void remove_nodes(const std::vector<cxptr<T>>& nodes,
+                     empty_edges policy = empty_edges::keep);
 
    cxptr<hyperedge<T>> add_edge(std::vector<cxptr<T>> nodes);
    void remove_edge(const cxptr<hyperedge<T>>& edge);
+   void remove_edge(handle<hyperedge<T>> edge);
 
    std::vector<cxptr<hyperedge<T>>>
    add_edges(std::vector<std::vector<cxptr<T>>> node_sets);
+
+   // removes a batch of edges, compacting the incidence list of every affected node once
    void remove_edges(const std::vector<cxptr<hyperedge<T>>>& edges);
 
    std::vector<cxptr<T>> get_nodes() const;
    std::vector<cxptr<hyperedge<T>>> get_edges() const;
 
+   // lazy views over all nodes and edges, invalidated by adding or removing elements
+   auto nodes() const;
+   auto edges() const;
+
+   // O(1) handle resolution. A handle to a removed element yields an empty cxptr.
+   cxptr<T> get_node(handle<T> node) const;
+   cxptr<hyperedge<T>> get_edge(handle<hyperedge<T>> edge) const;
+
+   bool contains(handle<T> node) const;
+   bool contains(handle<hyperedge<T>> edge) const;
+
+   // builds an immutable CSR snapshot of the current incidence structure for read-heavy use
+   compact_view<T> freeze() const;
+
+   // measures the memory held by the hypergraph in O(nodes + edges)
+   memory_footprint get_memory_footprint() const;
+
+   // releases the spare capacity of every incidence list and of the internal arrays
+   void shrink_to_fit();
+
+   // observers are not owned and must be detached before they are destroyed
+   void attach(hypergraph_observer<T>* observer);
+   void detach(hypergraph_observer<T>* observer);
+
+   // While a transaction is open every node and edge added or removed through the hypergraph is
+   // recorded in an undo log. Rolling back undoes the changes in reverse order in O(changes):
+   // removed elements come back with their handles, ids and positions in every incidence list,
+   // and observers see the edges change again. Transactions nest, committing an inner one hands
+   // its changes over to the enclosing one. Nodes added to or removed from an existing hyperedge
+   // directly are not recorded. Handles of elements added inside a transaction that is rolled back
+   // go stale like those of removed elements. See ctl::transaction for a scope guard.
+   void begin_transaction();
+   void commit_transaction();
+   void rollback_transaction();
+   size_t get_transaction_depth() const { return savepoints_.size(); }
+
  private:
-   std::vector<std::shared_ptr<T>> nodes_;
-   std::vector<std::shared_ptr<hyperedge<T>>> edges_;
+   struct undo_entry
+   {
+      enum class kind : std::uint8_t
+      {
+         node_inserted,
+         edge_inserted,
+         node_removed,
+         edge_removed
+      };
+
+      undo_entry() = default;
+      undo_entry(kind entry_type, handle<T> entry_node) : type(entry_type), node(entry_node) {}
+      undo_entry(kind entry_type, handle<hyperedge<T>> entry_edge)
+         : type(entry_type), edge(entry_edge)
+      {
+      }
+
+      kind type = kind::node_inserted;
+      handle<T> node{};
+      handle<hyperedge<T>> edge{};
+
+      // a removed element, with its dense position in the slot map and where it was erased from
+      // the incidence lists of its neighbours, as ranges of the shared undo arrays
+      std::shared_ptr<T> removed_node;
+      std::shared_ptr<hyperedge<T>> removed_edge;
+      size_t position        = 0;
+      size_t positions_begin = 0;
+      size_t positions_end   = 0;
+      size_t edges_begin     = 0;
+      size_t edges_end       = 0;
+   };
+
+   struct savepoint
+   {
+      size_t entries;
+      size_t positions;
+      size_t edges;
+      typename T::identity_policy id_policy;
+   };
+
+   void record_node_removal(const std::shared_ptr<T>& node);
+   void record_edge_removal(const std::shared_ptr<hyperedge<T>>& edge);
+   void undo(undo_entry& entry);
+   void truncate_undo_log(const savepoint& mark);
+
+   // the slab pool of a pooled hypergraph, heap hypergraphs have none
+   static std::shared_ptr<internal::slab_pool> make_pool(storage_mode mode);
+
+   template <typename U>
+   internal::pool_allocator<U> make_allocator() const;
+
+   cxptr<T> insert_node(std::shared_ptr<T> node);
+   cxptr<hyperedge<T>> insert_edge(std::shared_ptr<hyperedge<T>> edge);
+
+   // gives an edge its id and handle without linking it into the incidence lists of its nodes
+   void register_edge(const std::shared_ptr<hyperedge<T>>& edge);
+   void copy_elements(const hypergraph& rhs);
+   void release_elements();
+
+   internal::slot_map<std::shared_ptr<T>, handle<T>> nodes_;
+   internal::slot_map<std::shared_ptr<hyperedge<T>>, handle<hyperedge<T>>> edges_;
+
+   std::shared_ptr<internal::slab_pool> pool_;
+   storage_mode mode_;
+
+   typename T::identity_policy id_policy_;
+
+   std::vector<hypergraph_observer<T>*> observers_;
+
+   std::vector<undo_entry> undo_log_;
+   std::vector<std::uint32_t> undo_positions_;
+   std::vector<std::shared_ptr<hyperedge<T>>> undo_edges_;
+   std::vector<savepoint> savepoints_;
 };
 
 // ----- node -----
-template <typename T>
-node<T>::node() : internal::identity()
+template <typename T, typename IdentityPolicy>
+node<T, IdentityPolicy>::node() : internal::identity<IdentityPolicy>()
 {
 }
 
-template <typename T>
-std::vector<cxptr<hyperedge<T>>> node<T>::get_incident_edges() const
+template <typename T, typename IdentityPolicy>
+std::vector<cxptr<hyperedge<T>>> node<T, IdentityPolicy>::get_incident_edges() const
 {
    return internal::make_weak_ptr_vector(incident_edges_);
 }
 
-template <typename T>
-std::vector<cxptr<T>> node<T>::get_adjacent_nodes() const 
+template <typename T, typename IdentityPolicy>
+std::vector<cxptr<T>> node<T, IdentityPolicy>::get_adjacent_nodes() const 
 {
+   internal::operation_timer timer(instrumented_operation::adjacency_query);
    std::vector<cxptr<T>> adjacent_nodes;
 
    for (const std::shared_ptr<hyperedge<T>>& edge : incident_edges_)
@@ -168,8 +422,76 @@ std::vector<cxptr<T>> node<T>::get_adjacent_nodes() const
 }
 
 
-template <typename T>
-bool node<T>::is_adjacent_to(const cxptr<T>& node) const
+template <typename T, typename IdentityPolicy>
+auto node<T, IdentityPolicy>::incident_edges() const
+{
+   return incident_edges_ | std::views::transform(internal::dereference);
+}
+
+template <typename T, typename IdentityPolicy>
+auto node<T, IdentityPolicy>::adjacent_nodes() const
+{
+   const T* self = static_cast<const T*>(this);
+
+   return incident_edges_
+        | std::views::transform([](const std::shared_ptr<hyperedge<T>>& edge)
+             -> const std::vector<std::shared_ptr<T>>& { return edge->incident_nodes_; })
+        | std::views::join
+        | std::views::filter([self](const std::shared_ptr<T>& other_node)
+             { return other_node.get() != self; })
+        | std::views::transform(internal::dereference);
+}
+
+template <typename T, typename IdentityPolicy>
+template <typename Visitor>
+void node<T, IdentityPolicy>::visit_unique_adjacent_nodes(Visitor&& visitor) const
+{
+   internal::operation_timer timer(instrumented_operation::adjacency_query);
+   const std::uint64_t epoch = internal::next_visit_epoch();
+   visit_epoch_              = epoch;
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : incident_edges_)
+   {
+      // an edge is listed once per occurrence of this node in it
+      if (edge->visit_epoch_ == epoch)
+      {
+         continue;
+      }
+
+      edge->visit_epoch_ = epoch;
+
+      for (const std::shared_ptr<T>& other_node : edge->incident_nodes_)
+      {
+         if (other_node->visit_epoch_ != epoch)
+         {
+            other_node->visit_epoch_ = epoch;
+            visitor(other_node);
+         }
+      }
+   }
+}
+
+template <typename T, typename IdentityPolicy>
+std::vector<cxptr<T>> node<T, IdentityPolicy>::get_unique_adjacent_nodes() const
+{
+   std::vector<cxptr<T>> adjacent_nodes;
+
+   visit_unique_adjacent_nodes([&adjacent_nodes](const std::shared_ptr<T>& other_node)
+                               { adjacent_nodes.emplace_back(other_node); });
+
+   return adjacent_nodes;
+}
+
+template <typename T, typename IdentityPolicy>
+size_t node<T, IdentityPolicy>::count_adjacent_nodes() const
+{
+   size_t count = 0;
+   visit_unique_adjacent_nodes([&count](const std::shared_ptr<T>&) { ++count; });
+   return count;
+}
+
+template <typename T, typename IdentityPolicy>
+bool node<T, IdentityPolicy>::is_adjacent_to(const cxptr<T>& node) const
 {
    if (node.is_valid())
    {
@@ -190,19 +512,22 @@ bool node<T>::is_adjacent_to(const cxptr<T>& node) const
    return false;
 }
 
-template <typename T>
-bool node<T>::is_incident_to(const cxptr<hyperedge<T>>& edge) const
+template <typename T, typename IdentityPolicy>
+bool node<T, IdentityPolicy>::is_incident_to(const cxptr<hyperedge<T>>& edge) const
 {
    if (edge.is_valid())
    {
-      return std::find(incident_edges_.begin(), incident_edges_.begin(), edge.lock()) != incident_edges_.end();
+      const auto iter = std::find(incident_edges_.begin(), incident_edges_.end(), edge.lock());
+      internal::count_event(internal::instrumented_counter::scan_comparisons,
+                            iter - incident_edges_.begin() + (iter != incident_edges_.end()));
+      return iter != incident_edges_.end();
    }
 
    return false;
 }
 
-// template <typename T>
-// void node<T>::add_incident_edge(const cxptr<hyperedge<T>>& incident_edge)
+// template <typename T, typename IdentityPolicy>
+// void node<T, IdentityPolicy>::add_incident_edge(const cxptr<hyperedge<T>>& incident_edge)
 // {
 //    if (incident_edge.is_valid())
 //    {
@@ -210,8 +535,8 @@ bool node<T>::is_incident_to(const cxptr<hyperedge<T>>& edge) const
 //    }
 // }
 
-// template <typename T>
-// void node<T>::remove_incident_edge(const cxptr<hyperedge<T>>& incident_edge)
+// template <typename T, typename IdentityPolicy>
+// void node<T, IdentityPolicy>::remove_incident_edge(const cxptr<hyperedge<T>>& incident_edge)
 // {
 //    if (incident_edge.is_valid())
 //    {
@@ -219,28 +544,29 @@ bool node<T>::is_incident_to(const cxptr<hyperedge<T>>& edge) const
 //    }
 // }
 
-template <typename T>
-bool node<T>::operator==(const T& rhs) const
+template <typename T, typename IdentityPolicy>
+bool node<T, IdentityPolicy>::operator==(const T& rhs) const
 {
-   return internal::identity::operator==(rhs);
+   return internal::identity<IdentityPolicy>::operator==(rhs);
 }
 
-template <typename T>
-bool node<T>::operator!=(const T& rhs) const
+template <typename T, typename IdentityPolicy>
+bool node<T, IdentityPolicy>::operator!=(const T& rhs) const
 {
-   return internal::identity::operator!=(rhs);
+   return internal::identity<IdentityPolicy>::operator!=(rhs);
 }
 
 // ----- hyperedge -----
 
 template <typename T>
-hyperedge<T>::hyperedge() : internal::identity(), incident_nodes_(0)
+hyperedge<T>::hyperedge()
+   : internal::identity<typename T::identity_policy>(), incident_nodes_(0)
 {
 }
 
 template <typename T>
 hyperedge<T>::hyperedge(const std::vector<std::shared_ptr<T>>& nodes)
-   : internal::identity()
+   : internal::identity<typename T::identity_policy>()
 {
    incident_nodes_.reserve(nodes.size());
 
@@ -259,6 +585,7 @@ std::vector<cxptr<T>> hyperedge<T>::get_incident_nodes() const
 template <typename T>
 std::vector<cxptr<hyperedge<T>>> hyperedge<T>::get_adjacent_edges() const
 {
+   internal::operation_timer timer(instrumented_operation::adjacency_query);
    std::vector<cxptr<hyperedge<T>>> adjacent_edges;
 
    for (const std::shared_ptr<T>& node : incident_nodes_)
@@ -275,6 +602,72 @@ std::vector<cxptr<hyperedge<T>>> hyperedge<T>::get_adjacent_edges() const
    return adjacent_edges;
 }
 
+template <typename T>
+auto hyperedge<T>::incident_nodes() const
+{
+   return incident_nodes_ | std::views::transform(internal::dereference);
+}
+
+template <typename T>
+auto hyperedge<T>::adjacent_edges() const
+{
+   return incident_nodes_
+        | std::views::transform([](const std::shared_ptr<T>& node)
+             -> const std::vector<std::shared_ptr<hyperedge<T>>>& { return node->incident_edges_; })
+        | std::views::join
+        | std::views::filter([this](const std::shared_ptr<hyperedge<T>>& other_edge)
+             { return other_edge.get() != this; })
+        | std::views::transform(internal::dereference);
+}
+
+template <typename T>
+template <typename Visitor>
+void hyperedge<T>::visit_unique_adjacent_edges(Visitor&& visitor) const
+{
+   internal::operation_timer timer(instrumented_operation::adjacency_query);
+   const std::uint64_t epoch = internal::next_visit_epoch();
+   visit_epoch_              = epoch;
+
+   for (const std::shared_ptr<T>& node : incident_nodes_)
+   {
+      // a node can occur more than once in an edge
+      if (node->visit_epoch_ == epoch)
+      {
+         continue;
+      }
+
+      node->visit_epoch_ = epoch;
+
+      for (const std::shared_ptr<hyperedge<T>>& other_edge : node->incident_edges_)
+      {
+         if (other_edge->visit_epoch_ != epoch)
+         {
+            other_edge->visit_epoch_ = epoch;
+            visitor(other_edge);
+         }
+      }
+   }
+}
+
+template <typename T>
+std::vector<cxptr<hyperedge<T>>> hyperedge<T>::get_unique_adjacent_edges() const
+{
+   std::vector<cxptr<hyperedge<T>>> adjacent_edges;
+
+   visit_unique_adjacent_edges([&adjacent_edges](const std::shared_ptr<hyperedge<T>>& other_edge)
+                               { adjacent_edges.emplace_back(other_edge); });
+
+   return adjacent_edges;
+}
+
+template <typename T>
+size_t hyperedge<T>::count_adjacent_edges() const
+{
+   size_t count = 0;
+   visit_unique_adjacent_edges([&count](const std::shared_ptr<hyperedge<T>>&) { ++count; });
+   return count;
+}
+
 template <typename T>
 bool hyperedge<T>::is_adjacent_to(const cxptr<hyperedge<T>>& edge) const
 {
@@ -301,7 +694,10 @@ bool hyperedge<T>::is_incident_to(const cxptr<T>& node) const
 {
    if (node.is_valid())
    {
-      return std::find(incident_nodes_.begin(), incident_nodes_.end(), node.lock()) != incident_nodes_.end();
+      const auto iter = std::find(incident_nodes_.begin(), incident_nodes_.end(), node.lock());
+      internal::count_event(internal::instrumented_counter::scan_comparisons,
+                            iter - incident_nodes_.begin() + (iter != incident_nodes_.end()));
+      return iter != incident_nodes_.end();
    }
 
    return false;
@@ -420,7 +816,7 @@ void hyperedge<T>::remove_node(size_t at_index)
 
       if (std::find(incident_nodes_.begin(), incident_nodes_.end(), removed_node) == incident_nodes_.end())
       {
-         removed_node->incident_edges_.erase(this->shared_from_this());
+         std::erase(removed_node->incident_edges_, this->shared_from_this());
       }
    }
 }
@@ -439,7 +835,7 @@ void hyperedge<T>::remove_nodes(size_t from_index, size_t to_index)
       {
          if (std::find(incident_nodes_.begin(), incident_nodes_.end(), removed_node) == incident_nodes_.end())
          {
-            removed_node->incident_edges_.erase(this->shared_from_this());
+            std::erase(removed_node->incident_edges_, this->shared_from_this());
          }
       }
    }
@@ -448,193 +844,956 @@ void hyperedge<T>::remove_nodes(size_t from_index, size_t to_index)
 template <typename T>
 bool hyperedge<T>::operator==(const hyperedge<T>& rhs) const
 {
-   return internal::identity::operator==(rhs);
+   return internal::identity<typename T::identity_policy>::operator==(rhs);
 }
 
 template <typename T>
 bool hyperedge<T>::operator!=(const hyperedge<T>& rhs) const
 {
-   return internal::identity::operator!=(rhs);
+   return internal::identity<typename T::identity_policy>::operator!=(rhs);
 }
 
 // ----- hypergraph -----
 
 template <typename T>
-hypergraph<T>::hypergraph() : internal::identity()
+hypergraph<T>::hypergraph() : hypergraph(storage_mode::heap)
 {
 }
 
 template <typename T>
-template <typename... Args>
-cxptr<T> hypergraph<T>::add_node(Args&&... args)
+hypergraph<T>::hypergraph(storage_mode mode)
+   : internal::identity<typename T::identity_policy>(T::identity_policy::next_global()),
+     pool_(make_pool(mode)), mode_(mode)
 {
-   std::shared_ptr<T> node = std::make_shared<T>(args...);
-   return nodes_.emplace_back(node);
 }
 
 template <typename T>
-cxptr<T> hypergraph<T>::add_node(T&& node)
+hypergraph<T>::hypergraph(const hypergraph& rhs)
+   : internal::identity<typename T::identity_policy>(T::identity_policy::next_global()),
+     pool_(make_pool(rhs.mode_)), mode_(rhs.mode_), id_policy_(rhs.id_policy_)
 {
-   return nodes_.emplace_back(std::make_shared<T>(std::forward<T>(node)));
+   copy_elements(rhs);
 }
 
 template <typename T>
-void hypergraph<T>::remove_node(const cxptr<T>& node)
+hypergraph<T>& hypergraph<T>::operator=(const hypergraph& rhs)
 {
-   if (node.is_valid())
+   if (this != &rhs)
    {
-      for (auto& edge : edges_)
-      {
-         std::vector<std::shared_ptr<T>>& edge_nodes = edge->incident_nodes_;
-         edge_nodes.erase(std::remove(edge_nodes.begin(), edge_nodes.end(), node.lock()));
-      }
-
-      nodes_.erase(std::remove(nodes_.begin(), nodes_.end(), node.lock()));
+      *this = hypergraph(rhs);
    }
+
+   return *this;
 }
 
 template <typename T>
-std::vector<cxptr<T>> hypergraph<T>::add_nodes(size_t count)
+hypergraph<T>::hypergraph(hypergraph&& rhs) noexcept
+   : internal::identity<typename T::identity_policy>(std::move(rhs)),
+     nodes_(std::move(rhs.nodes_)), edges_(std::move(rhs.edges_)), pool_(std::move(rhs.pool_)),
+     mode_(std::exchange(rhs.mode_, storage_mode::heap)), id_policy_(std::move(rhs.id_policy_)),
+     observers_(std::move(rhs.observers_)), undo_log_(std::move(rhs.undo_log_)),
+     undo_positions_(std::move(rhs.undo_positions_)), undo_edges_(std::move(rhs.undo_edges_)),
+     savepoints_(std::move(rhs.savepoints_))
 {
-   std::vector<cxptr<T>> new_nodes;
-   new_nodes.reserve(count);
+}
 
-   for (size_t i = 0; i < count; ++i)
+template <typename T>
+hypergraph<T>& hypergraph<T>::operator=(hypergraph&& rhs)
+{
+   if (this != &rhs)
    {
-      new_nodes.emplace_back(add_node());
+      release_elements();
+      internal::identity<typename T::identity_policy>::operator=(std::move(rhs));
+      nodes_     = std::move(rhs.nodes_);
+      edges_     = std::move(rhs.edges_);
+      pool_      = std::move(rhs.pool_);
+      mode_      = std::exchange(rhs.mode_, storage_mode::heap);
+      id_policy_ = std::move(rhs.id_policy_);
+      observers_ = std::move(rhs.observers_);
+
+      undo_log_       = std::move(rhs.undo_log_);
+      undo_positions_ = std::move(rhs.undo_positions_);
+      undo_edges_     = std::move(rhs.undo_edges_);
+      savepoints_     = std::move(rhs.savepoints_);
    }
 
-   return new_nodes;
+   return *this;
 }
 
 template <typename T>
-void hypergraph<T>::remove_nodes(const std::vector<cxptr<T>>& nodes)
+hypergraph<T>::~hypergraph()
 {
-   for (auto& node : nodes)
+   release_elements();
+}
+
+// nodes and edges hold shared_ptrs to each other, so the cycles have to be broken for the
+// elements to be released
+template <typename T>
+void hypergraph<T>::release_elements()
+{
+   for (std::shared_ptr<T>& node : nodes_)
    {
-      remove_node(node);
+      node->incident_edges_.clear();
    }
 }
 
+// copies the slot maps, so handles carry over, and then replaces every element by a copy with
+// its incidence lists pointing into the copied elements, in the same order
 template <typename T>
-cxptr<hyperedge<T>>
-hypergraph<T>::add_edge(std::vector<cxptr<T>> nodes)
+void hypergraph<T>::copy_elements(const hypergraph& rhs)
 {
-   std::vector<std::shared_ptr<T>> locked_nodes;
-   locked_nodes.reserve(nodes.size());
+   nodes_ = rhs.nodes_;
+   edges_ = rhs.edges_;
 
-   std::copy_if(nodes.begin(), nodes.end(), std::back_inserter(locked_nodes),
-      [](const cxptr<T>& node) { return node.is_valid(); });
-   
-   if (locked_nodes.size() != nodes.size())
+   for (std::shared_ptr<T>& node : nodes_)
    {
-      return std::shared_ptr<hyperedge<T>>(nullptr);
+      node = std::allocate_shared<T>(make_allocator<T>(), *node);
    }
 
-   std::shared_ptr<hyperedge<T>> edge = edges_.emplace_back(std::make_shared<hyperedge<T>>(locked_nodes));
-
-   std::for_each(locked_nodes.begin(), locked_nodes.end(), [&edge](std::shared_ptr<T>& node)
+   for (std::shared_ptr<hyperedge<T>>& edge : edges_)
    {
-      node->incident_edges_.emplace_back(edge);
-   });
+      edge = std::allocate_shared<hyperedge<T>>(make_allocator<hyperedge<T>>(), *edge);
 
-   return edge;
+      for (std::shared_ptr<T>& node : edge->incident_nodes_)
+      {
+         node = *nodes_.find(node->get_handle());
+      }
+   }
+
+   for (std::shared_ptr<T>& node : nodes_)
+   {
+      for (std::shared_ptr<hyperedge<T>>& edge : node->incident_edges_)
+      {
+         edge = *edges_.find(edge->get_handle());
+      }
+   }
 }
 
 template <typename T>
-void hypergraph<T>::remove_edge(const cxptr<hyperedge<T>>& edge)
+std::shared_ptr<internal::slab_pool> hypergraph<T>::make_pool(storage_mode mode)
 {
-   if (edge.is_valid())
+   if (mode != storage_mode::pooled)
    {
-      typename std::vector<std::shared_ptr<hyperedge<T>>>::iterator iter 
-         = std::find(edges_.begin(), edges_.end(), edge.lock());
-
-      if (iter != edges_.end())
-      {
-         std::shared_ptr<hyperedge<T>>& removed_edge = *iter;
-         std::vector<std::shared_ptr<T>>& incident_nodes = removed_edge->incident_nodes_;
-
-         std::for_each(incident_nodes.begin(), incident_nodes.end(), [&removed_edge](std::shared_ptr<T>& node)
-         {
-            std::vector<std::shared_ptr<hyperedge<T>>>& incident_edges = node->incident_edges_;
+      return nullptr;
+   }
 
-            incident_edges.erase(std::remove_if(incident_edges.begin(), incident_edges.end(), 
-               [&removed_edge](std::shared_ptr<hyperedge<T>>& incident_edge)
-            {
-               return incident_edge == removed_edge;
-            }));
-         });
-      }
+   return std::shared_ptr<internal::slab_pool>(internal::slab_pool::create(),
+                                               [](internal::slab_pool* pool) { pool->release(); });
+}
 
-      edges_.erase(iter);
-   }
+template <typename T>
+template <typename U>
+internal::pool_allocator<U> hypergraph<T>::make_allocator() const
+{
+   return internal::pool_allocator<U>(pool_.get());
 }
 
 template <typename T>
-std::vector<cxptr<hyperedge<T>>>
-hypergraph<T>::add_edges(std::vector<std::vector<cxptr<T>>> node_sets)
+cxptr<T> hypergraph<T>::insert_node(std::shared_ptr<T> node)
 {
-   std::vector<std::vector<std::shared_ptr<T>>> locked_node_sets;
-   locked_node_sets.reserve(node_sets.size());
+   node->id_     = id_policy_.next();
+   node->handle_ = nodes_.insert(node, savepoints_.empty());
 
-   std::for_each(node_sets.begin(), node_sets.end(), [&locked_node_sets](std::vector<cxptr<T>>& nodes)
+   if (!savepoints_.empty())
    {
-      std::vector<std::shared_ptr<T>> locked_nodes;
-      locked_nodes.reserve(nodes.size());
+      undo_log_.push_back(undo_entry(undo_entry::kind::node_inserted, node->handle_));
+   }
 
-      std::copy_if(nodes.begin(), nodes.end(), std::back_inserter(locked_nodes),
-         [](const cxptr<T>& node) { return node.is_valid(); });
+   return node;
+}
 
-      if (locked_nodes.size() == nodes.size())
-      {
-         locked_node_sets.emplace_back(locked_nodes);
-      }
-   });
+template <typename T>
+void hypergraph<T>::register_edge(const std::shared_ptr<hyperedge<T>>& edge)
+{
+   edge->id_     = id_policy_.next();
+   edge->handle_ = edges_.insert(edge, savepoints_.empty());
 
-   if (locked_node_sets.size() == node_sets.size())
+   if (!savepoints_.empty())
    {
-      size_t original_size = edges_.size();
+      undo_log_.push_back(undo_entry(undo_entry::kind::edge_inserted, edge->handle_));
+   }
+}
 
-      std::for_each(locked_node_sets.begin(), locked_node_sets.end(), [this](std::vector<std::shared_ptr<T>>& node_set)
-      {
-         std::shared_ptr<hyperedge<T>> edge = edges_.emplace_back(std::make_shared<hyperedge<T>>(node_set));
+template <typename T>
+cxptr<hyperedge<T>> hypergraph<T>::insert_edge(std::shared_ptr<hyperedge<T>> edge)
+{
+   register_edge(edge);
 
-         std::for_each(node_set.begin(), node_set.end(), [&edge](std::shared_ptr<T>& node)
-         {
-            node->incident_edges_.emplace_back(edge);
-         });
-      });
+   for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+   {
+      node->incident_edges_.emplace_back(edge);
+   }
 
-      // Create a vector of the newly added edges
-      std::vector<cxptr<hyperedge<T>>> new_edges;
-      new_edges.reserve(edges_.size() - original_size);
-      for (size_t i = original_size; i < edges_.size(); ++i) {
-         new_edges.emplace_back(edges_[i]);
-      }
-      return new_edges;
+   for (hypergraph_observer<T>* observer : observers_)
+   {
+      observer->on_edge_added(*edge);
    }
 
-   return std::vector<cxptr<hyperedge<T>>>();
+   return edge;
 }
 
 template <typename T>
-void hypergraph<T>::remove_edges(const std::vector<cxptr<hyperedge<T>>>& edges)
+template <typename... Args>
+cxptr<T> hypergraph<T>::add_node(Args&&... args)
 {
-   for (auto& edge : edges)
-   {
-      remove_edge(edge);
-   }
+   return insert_node(std::allocate_shared<T>(make_allocator<T>(), std::forward<Args>(args)...));
 }
 
 template <typename T>
-std::vector<cxptr<T>> hypergraph<T>::get_nodes() const
+cxptr<T> hypergraph<T>::add_node(T&& node)
 {
-   return internal::make_weak_ptr_vector(nodes_);
+   return insert_node(std::allocate_shared<T>(make_allocator<T>(), std::forward<T>(node)));
 }
 
 template <typename T>
-std::vector<cxptr<hyperedge<T>>> hypergraph<T>::get_edges() const
+void hypergraph<T>::remove_node(const cxptr<T>& node)
 {
-   return internal::make_weak_ptr_vector(edges_);
+   if (std::shared_ptr<T> locked_node = node.lock())
+   {
+      const std::shared_ptr<T>* stored_node = nodes_.find(locked_node->handle_);
+
+      if (stored_node != nullptr && *stored_node == locked_node)
+      {
+         remove_node(locked_node->handle_);
+      }
+   }
+}
+
+template <typename T>
+void hypergraph<T>::remove_node(handle<T> node)
+{
+   internal::operation_timer timer(instrumented_operation::remove_node);
+   std::shared_ptr<T>* stored_node = nodes_.find(node);
+
+   if (stored_node != nullptr)
+   {
+      std::shared_ptr<T> removed_node = *stored_node;
+      std::vector<std::shared_ptr<hyperedge<T>>> changed_edges;
+
+      if (!observers_.empty())
+      {
+         changed_edges = removed_node->incident_edges_;
+         changed_edges.erase(std::unique(changed_edges.begin(), changed_edges.end()),
+                             changed_edges.end());
+
+         for (const std::shared_ptr<hyperedge<T>>& edge : changed_edges)
+         {
+            for (hypergraph_observer<T>* observer : observers_)
+            {
+               observer->on_edge_removed(*edge);
+            }
+         }
+      }
+
+      if (!savepoints_.empty())
+      {
+         record_node_removal(removed_node);
+      }
+
+      // only the edges this node is a member of have to be visited. An edge is listed once per
+      // occurrence of the node, so later visits of the same edge find nothing left to erase.
+      for (const std::shared_ptr<hyperedge<T>>& edge : removed_node->incident_edges_)
+      {
+         internal::count_event(internal::instrumented_counter::scan_comparisons,
+                               edge->incident_nodes_.size());
+         std::erase(edge->incident_nodes_, removed_node);
+      }
+
+      if (!savepoints_.empty())
+      {
+         // the undo log keeps the incidence list, in order, to restore it on rollback
+         undo_edges_.insert(undo_edges_.end(),
+                            std::make_move_iterator(removed_node->incident_edges_.begin()),
+                            std::make_move_iterator(removed_node->incident_edges_.end()));
+         undo_log_.back().edges_end = undo_edges_.size();
+      }
+
+      removed_node->incident_edges_.clear();
+      nodes_.erase(node);
+
+      for (const std::shared_ptr<hyperedge<T>>& edge : changed_edges)
+      {
+         for (hypergraph_observer<T>* observer : observers_)
+         {
+            observer->on_edge_added(*edge);
+         }
+      }
+   }
+}
+
+template <typename T>
+std::vector<cxptr<T>> hypergraph<T>::add_nodes(size_t count)
+{
+   std::vector<cxptr<T>> new_nodes;
+   new_nodes.reserve(count);
+   nodes_.reserve(nodes_.size() + count);
+
+   for (size_t i = 0; i < count; ++i)
+   {
+      new_nodes.emplace_back(add_node());
+   }
+
+   return new_nodes;
+}
+
+template <typename T>
+void hypergraph<T>::remove_nodes(const std::vector<cxptr<T>>& nodes, empty_edges policy)
+{
+   const std::uint64_t epoch = internal::next_visit_epoch();
+   std::vector<std::shared_ptr<T>> removed_nodes;
+   std::vector<std::shared_ptr<hyperedge<T>>> changed_edges;
+   removed_nodes.reserve(nodes.size());
+
+   // mark the nodes of this graph in the batch, and then the edges containing any of them
+   for (const cxptr<T>& node : nodes)
+   {
+      std::shared_ptr<T> locked_node = node.lock();
+
+      if (locked_node && locked_node->visit_epoch_ != epoch)
+      {
+         const std::shared_ptr<T>* stored_node = nodes_.find(locked_node->handle_);
+
+         if (stored_node != nullptr && *stored_node == locked_node)
+         {
+            locked_node->visit_epoch_ = epoch;
+            removed_nodes.push_back(std::move(locked_node));
+         }
+      }
+   }
+
+   for (const std::shared_ptr<T>& node : removed_nodes)
+   {
+      for (const std::shared_ptr<hyperedge<T>>& edge : node->incident_edges_)
+      {
+         if (edge->visit_epoch_ != epoch)
+         {
+            edge->visit_epoch_ = epoch;
+            changed_edges.push_back(edge);
+         }
+      }
+   }
+
+   if (!savepoints_.empty())
+   {
+      // inside a transaction every removal goes through the undo log
+      for (const std::shared_ptr<T>& node : removed_nodes)
+      {
+         remove_node(node->handle_);
+      }
+   }
+   else
+   {
+      for (const std::shared_ptr<hyperedge<T>>& edge : changed_edges)
+      {
+         for (hypergraph_observer<T>* observer : observers_)
+         {
+            observer->on_edge_removed(*edge);
+         }
+      }
+
+      for (const std::shared_ptr<hyperedge<T>>& edge : changed_edges)
+      {
+         internal::count_event(internal::instrumented_counter::scan_comparisons,
+                               edge->incident_nodes_.size());
+         std::erase_if(edge->incident_nodes_, [epoch](const std::shared_ptr<T>& node)
+                       { return node->visit_epoch_ == epoch; });
+      }
+
+      for (const std::shared_ptr<T>& node : removed_nodes)
+      {
+         node->incident_edges_.clear();
+         nodes_.erase(node->handle_);
+      }
+
+      for (const std::shared_ptr<hyperedge<T>>& edge : changed_edges)
+      {
+         if (policy == empty_edges::keep || !edge->incident_nodes_.empty())
+         {
+            for (hypergraph_observer<T>* observer : observers_)
+            {
+               observer->on_edge_added(*edge);
+            }
+         }
+      }
+   }
+
+   if (policy == empty_edges::remove)
+   {
+      for (const std::shared_ptr<hyperedge<T>>& edge : changed_edges)
+      {
+         if (!edge->incident_nodes_.empty())
+         {
+            continue;
+         }
+
+         if (!savepoints_.empty())
+         {
+            remove_edge(edge->handle_);
+         }
+         else
+         {
+            // observers have already seen the edge go, and no node lists it anymore
+            edges_.erase(edge->handle_);
+         }
+      }
+   }
+}
+
+template <typename T>
+cxptr<hyperedge<T>>
+hypergraph<T>::add_edge(std::vector<cxptr<T>> nodes)
+{
+   internal::operation_timer timer(instrumented_operation::add_edge);
+   std::vector<std::shared_ptr<T>> locked_nodes;
+   locked_nodes.reserve(nodes.size());
+
+   std::copy_if(nodes.begin(), nodes.end(), std::back_inserter(locked_nodes),
+      [](const cxptr<T>& node) { return node.is_valid(); });
+   
+   if (locked_nodes.size() != nodes.size())
+   {
+      return std::shared_ptr<hyperedge<T>>(nullptr);
+   }
+
+   return insert_edge(
+      std::allocate_shared<hyperedge<T>>(make_allocator<hyperedge<T>>(), locked_nodes));
+}
+
+template <typename T>
+void hypergraph<T>::remove_edge(const cxptr<hyperedge<T>>& edge)
+{
+   if (std::shared_ptr<hyperedge<T>> locked_edge = edge.lock())
+   {
+      const std::shared_ptr<hyperedge<T>>* stored_edge = edges_.find(locked_edge->handle_);
+
+      if (stored_edge != nullptr && *stored_edge == locked_edge)
+      {
+         remove_edge(locked_edge->handle_);
+      }
+   }
+}
+
+template <typename T>
+void hypergraph<T>::remove_edge(handle<hyperedge<T>> edge)
+{
+   internal::operation_timer timer(instrumented_operation::remove_edge);
+   std::shared_ptr<hyperedge<T>>* stored_edge = edges_.find(edge);
+
+   if (stored_edge != nullptr)
+   {
+      std::shared_ptr<hyperedge<T>> removed_edge = *stored_edge;
+
+      for (hypergraph_observer<T>* observer : observers_)
+      {
+         observer->on_edge_removed(*removed_edge);
+      }
+
+      if (!savepoints_.empty())
+      {
+         record_edge_removal(removed_edge);
+      }
+
+      for (const std::shared_ptr<T>& node : removed_edge->incident_nodes_)
+      {
+         internal::count_event(internal::instrumented_counter::scan_comparisons,
+                               node->incident_edges_.size());
+         std::erase(node->incident_edges_, removed_edge);
+      }
+
+      edges_.erase(edge);
+   }
+}
+
+template <typename T>
+std::vector<cxptr<hyperedge<T>>>
+hypergraph<T>::add_edges(std::vector<std::vector<cxptr<T>>> node_sets)
+{
+   std::vector<std::vector<std::shared_ptr<T>>> locked_node_sets;
+   locked_node_sets.reserve(node_sets.size());
+
+   std::for_each(node_sets.begin(), node_sets.end(), [&locked_node_sets](std::vector<cxptr<T>>& nodes)
+   {
+      std::vector<std::shared_ptr<T>> locked_nodes;
+      locked_nodes.reserve(nodes.size());
+
+      std::copy_if(nodes.begin(), nodes.end(), std::back_inserter(locked_nodes),
+         [](const cxptr<T>& node) { return node.is_valid(); });
+
+      if (locked_nodes.size() == nodes.size())
+      {
+         locked_node_sets.emplace_back(locked_nodes);
+      }
+   });
+
+   if (locked_node_sets.size() == node_sets.size())
+   {
+      size_t original_size = edges_.size();
+
+      std::vector<cxptr<hyperedge<T>>> new_edges;
+      new_edges.reserve(locked_node_sets.size());
+      edges_.reserve(original_size + locked_node_sets.size());
+
+      std::for_each(locked_node_sets.begin(), locked_node_sets.end(),
+                    [this, &new_edges](std::vector<std::shared_ptr<T>>& node_set)
+      {
+         new_edges.emplace_back(insert_edge(
+            std::allocate_shared<hyperedge<T>>(make_allocator<hyperedge<T>>(), node_set)));
+      });
+
+      return new_edges;
+   }
+
+   return std::vector<cxptr<hyperedge<T>>>();
+}
+
+template <typename T>
+void hypergraph<T>::remove_edges(const std::vector<cxptr<hyperedge<T>>>& edges)
+{
+   if (!savepoints_.empty())
+   {
+      // inside a transaction every removal goes through the undo log
+      for (const cxptr<hyperedge<T>>& edge : edges)
+      {
+         remove_edge(edge);
+      }
+
+      return;
+   }
+
+   const std::uint64_t epoch = internal::next_visit_epoch();
+   std::vector<std::shared_ptr<hyperedge<T>>> removed_edges;
+   std::vector<T*> changed_nodes;
+   removed_edges.reserve(edges.size());
+
+   for (const cxptr<hyperedge<T>>& edge : edges)
+   {
+      std::shared_ptr<hyperedge<T>> locked_edge = edge.lock();
+
+      if (locked_edge && locked_edge->visit_epoch_ != epoch)
+      {
+         const std::shared_ptr<hyperedge<T>>* stored_edge = edges_.find(locked_edge->handle_);
+
+         if (stored_edge != nullptr && *stored_edge == locked_edge)
+         {
+            locked_edge->visit_epoch_ = epoch;
+            removed_edges.push_back(std::move(locked_edge));
+         }
+      }
+   }
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : removed_edges)
+   {
+      for (hypergraph_observer<T>* observer : observers_)
+      {
+         observer->on_edge_removed(*edge);
+      }
+
+      for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+      {
+         if (node->visit_epoch_ != epoch)
+         {
+            node->visit_epoch_ = epoch;
+            changed_nodes.push_back(node.get());
+         }
+      }
+   }
+
+   for (T* node : changed_nodes)
+   {
+      internal::count_event(internal::instrumented_counter::scan_comparisons,
+                            node->incident_edges_.size());
+      std::erase_if(node->incident_edges_, [epoch](const std::shared_ptr<hyperedge<T>>& edge)
+                    { return edge->visit_epoch_ == epoch; });
+   }
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : removed_edges)
+   {
+      edges_.erase(edge->handle_);
+   }
+}
+
+template <typename T>
+std::vector<cxptr<T>> hypergraph<T>::get_nodes() const
+{
+   return internal::make_weak_ptr_vector(nodes_.values());
+}
+
+template <typename T>
+std::vector<cxptr<hyperedge<T>>> hypergraph<T>::get_edges() const
+{
+   return internal::make_weak_ptr_vector(edges_.values());
+}
+
+template <typename T>
+auto hypergraph<T>::nodes() const
+{
+   return nodes_.values() | std::views::transform(internal::dereference);
+}
+
+template <typename T>
+auto hypergraph<T>::edges() const
+{
+   return edges_.values() | std::views::transform(internal::dereference);
+}
+
+template <typename T>
+cxptr<T> hypergraph<T>::get_node(handle<T> node) const
+{
+   const std::shared_ptr<T>* stored_node = nodes_.find(node);
+   return stored_node != nullptr ? cxptr<T>(*stored_node) : cxptr<T>();
+}
+
+template <typename T>
+cxptr<hyperedge<T>> hypergraph<T>::get_edge(handle<hyperedge<T>> edge) const
+{
+   const std::shared_ptr<hyperedge<T>>* stored_edge = edges_.find(edge);
+   return stored_edge != nullptr ? cxptr<hyperedge<T>>(*stored_edge) : cxptr<hyperedge<T>>();
+}
+
+template <typename T>
+bool hypergraph<T>::contains(handle<T> node) const
+{
+   return nodes_.contains(node);
+}
+
+template <typename T>
+bool hypergraph<T>::contains(handle<hyperedge<T>> edge) const
+{
+   return edges_.contains(edge);
+}
+
+template <typename T>
+memory_footprint hypergraph<T>::get_memory_footprint() const
+{
+   using edge_type = hyperedge<T>;
+
+   memory_footprint footprint;
+   footprint.node_bytes = nodes_.size() * sizeof(T);
+   footprint.edge_bytes = edges_.size() * sizeof(edge_type);
+   footprint.control_block_bytes =
+      nodes_.size() * internal::control_block_overhead<T> +
+      edges_.size() * internal::control_block_overhead<edge_type>;
+
+   auto add_list = [&footprint](const auto& list)
+   {
+      using element_type = typename std::decay_t<decltype(list)>::value_type;
+      footprint.incidence_bytes += list.size() * sizeof(element_type);
+      footprint.incidence_slack_bytes += (list.capacity() - list.size()) * sizeof(element_type);
+   };
+
+   for (const std::shared_ptr<T>& node : nodes_)
+   {
+      add_list(node->incident_edges_);
+   }
+
+   for (const std::shared_ptr<edge_type>& edge : edges_)
+   {
+      add_list(edge->incident_nodes_);
+   }
+
+   footprint.index_bytes = nodes_.get_memory_usage() + edges_.get_memory_usage() +
+                           observers_.capacity() * sizeof(hypergraph_observer<T>*);
+   footprint.undo_log_bytes = undo_log_.capacity() * sizeof(undo_entry) +
+                              undo_positions_.capacity() * sizeof(std::uint32_t) +
+                              undo_edges_.capacity() * sizeof(std::shared_ptr<edge_type>) +
+                              savepoints_.capacity() * sizeof(savepoint);
+
+   if (pool_ != nullptr)
+   {
+      footprint.pool_reserved_bytes = pool_->get_reserved_bytes();
+   }
+
+   return footprint;
+}
+
+template <typename T>
+void hypergraph<T>::shrink_to_fit()
+{
+   for (const std::shared_ptr<T>& node : nodes_)
+   {
+      node->incident_edges_.shrink_to_fit();
+   }
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : edges_)
+   {
+      edge->incident_nodes_.shrink_to_fit();
+   }
+
+   nodes_.shrink_to_fit();
+   edges_.shrink_to_fit();
+   observers_.shrink_to_fit();
+   undo_log_.shrink_to_fit();
+   undo_positions_.shrink_to_fit();
+   undo_edges_.shrink_to_fit();
+   savepoints_.shrink_to_fit();
+}
+
+template <typename T>
+compact_view<T> hypergraph<T>::freeze() const
+{
+   return compact_view<T>(*this);
+}
+
+template <typename T>
+void hypergraph<T>::attach(hypergraph_observer<T>* observer)
+{
+   if (observer != nullptr &&
+       std::find(observers_.begin(), observers_.end(), observer) == observers_.end())
+   {
+      observers_.push_back(observer);
+   }
+}
+
+template <typename T>
+void hypergraph<T>::detach(hypergraph_observer<T>* observer)
+{
+   std::erase(observers_, observer);
+}
+
+template <typename T>
+void hypergraph<T>::begin_transaction()
+{
+   savepoints_.push_back(
+      savepoint{undo_log_.size(), undo_positions_.size(), undo_edges_.size(), id_policy_});
+}
+
+template <typename T>
+void hypergraph<T>::commit_transaction()
+{
+   if (savepoints_.empty())
+   {
+      throw std::logic_error("There is no open transaction to commit.");
+   }
+
+   savepoints_.pop_back();
+
+   // the outermost commit makes the changes permanent and lets go of removed elements
+   if (savepoints_.empty())
+   {
+      truncate_undo_log(savepoint{0, 0, 0, id_policy_});
+   }
+}
+
+template <typename T>
+void hypergraph<T>::rollback_transaction()
+{
+   if (savepoints_.empty())
+   {
+      throw std::logic_error("There is no open transaction to roll back.");
+   }
+
+   const savepoint mark = std::move(savepoints_.back());
+   savepoints_.pop_back();
+
+   for (size_t entry = undo_log_.size(); entry > mark.entries; --entry)
+   {
+      undo(undo_log_[entry - 1]);
+   }
+
+   truncate_undo_log(mark);
+   id_policy_ = mark.id_policy;
+}
+
+template <typename T>
+void hypergraph<T>::truncate_undo_log(const savepoint& mark)
+{
+   undo_log_.resize(mark.entries);
+   undo_positions_.resize(mark.positions);
+   undo_edges_.resize(mark.edges);
+}
+
+// for every distinct edge of the node, in incidence order: the number of occurrences of the node
+// in the edge followed by their positions
+template <typename T>
+void hypergraph<T>::record_node_removal(const std::shared_ptr<T>& node)
+{
+   undo_entry entry(undo_entry::kind::node_removed, node->handle_);
+   entry.removed_node    = node;
+   entry.position        = nodes_.position_of_key(node->handle_);
+   entry.positions_begin = undo_positions_.size();
+   entry.edges_begin     = undo_edges_.size();
+
+   const std::uint64_t epoch = internal::next_visit_epoch();
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : node->incident_edges_)
+   {
+      if (edge->visit_epoch_ == epoch)
+      {
+         continue;
+      }
+
+      edge->visit_epoch_ = epoch;
+
+      const size_t count_at = undo_positions_.size();
+      undo_positions_.push_back(0);
+
+      for (size_t position = 0; position < edge->incident_nodes_.size(); ++position)
+      {
+         if (edge->incident_nodes_[position] == node)
+         {
+            undo_positions_.push_back(static_cast<std::uint32_t>(position));
+            ++undo_positions_[count_at];
+         }
+      }
+   }
+
+   entry.positions_end = undo_positions_.size();
+   entry.edges_end     = entry.edges_begin;
+   undo_log_.push_back(std::move(entry));
+}
+
+// like record_node_removal, with the positions of the edge in the incidence lists of its nodes
+template <typename T>
+void hypergraph<T>::record_edge_removal(const std::shared_ptr<hyperedge<T>>& edge)
+{
+   undo_entry entry(undo_entry::kind::edge_removed, edge->handle_);
+   entry.removed_edge    = edge;
+   entry.position        = edges_.position_of_key(edge->handle_);
+   entry.positions_begin = undo_positions_.size();
+
+   const std::uint64_t epoch = internal::next_visit_epoch();
+
+   for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+   {
+      if (node->visit_epoch_ == epoch)
+      {
+         continue;
+      }
+
+      node->visit_epoch_ = epoch;
+
+      const size_t count_at = undo_positions_.size();
+      undo_positions_.push_back(0);
+
+      for (size_t position = 0; position < node->incident_edges_.size(); ++position)
+      {
+         if (node->incident_edges_[position] == edge)
+         {
+            undo_positions_.push_back(static_cast<std::uint32_t>(position));
+            ++undo_positions_[count_at];
+         }
+      }
+   }
+
+   entry.positions_end = undo_positions_.size();
+   undo_log_.push_back(std::move(entry));
+}
+
+// undoes one change. Every later change has been undone already, so the graph is exactly in the
+// state the change left it in.
+template <typename T>
+void hypergraph<T>::undo(undo_entry& entry)
+{
+   switch (entry.type)
+   {
+   case undo_entry::kind::node_inserted:
+   {
+      nodes_.undo_insert(entry.node);
+      break;
+   }
+   case undo_entry::kind::edge_inserted:
+   {
+      std::shared_ptr<hyperedge<T>> edge = *edges_.find(entry.edge);
+
+      for (hypergraph_observer<T>* observer : observers_)
+      {
+         observer->on_edge_removed(*edge);
+      }
+
+      // the edge was appended to the incidence list of each of its nodes once per occurrence
+      for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+      {
+         node->incident_edges_.pop_back();
+      }
+
+      edges_.undo_insert(entry.edge);
+      break;
+   }
+   case undo_entry::kind::node_removed:
+   {
+      std::shared_ptr<T>& node  = entry.removed_node;
+      const auto first_edge     = undo_edges_.begin() + entry.edges_begin;
+      const auto last_edge      = undo_edges_.begin() + entry.edges_end;
+      const std::uint64_t epoch = internal::next_visit_epoch();
+      size_t cursor             = entry.positions_begin;
+
+      node->incident_edges_.assign(first_edge, last_edge);
+
+      for (auto edge = first_edge; edge != last_edge; ++edge)
+      {
+         if ((*edge)->visit_epoch_ == epoch)
+         {
+            continue;
+         }
+
+         (*edge)->visit_epoch_ = epoch;
+
+         for (hypergraph_observer<T>* observer : observers_)
+         {
+            observer->on_edge_removed(**edge);
+         }
+
+         std::vector<std::shared_ptr<T>>& edge_nodes = (*edge)->incident_nodes_;
+         const size_t count                          = undo_positions_[cursor++];
+
+         for (size_t occurrence = 0; occurrence < count; ++occurrence)
+         {
+            edge_nodes.insert(edge_nodes.begin() + undo_positions_[cursor++], node);
+         }
+      }
+
+      nodes_.restore(entry.node, std::move(node), entry.position);
+
+      const std::uint64_t added_epoch = internal::next_visit_epoch();
+
+      for (auto edge = first_edge; edge != last_edge; ++edge)
+      {
+         if ((*edge)->visit_epoch_ != added_epoch)
+         {
+            (*edge)->visit_epoch_ = added_epoch;
+
+            for (hypergraph_observer<T>* observer : observers_)
+            {
+               observer->on_edge_added(**edge);
+            }
+         }
+      }
+
+      break;
+   }
+   case undo_entry::kind::edge_removed:
+   {
+      const std::shared_ptr<hyperedge<T>>& edge = entry.removed_edge;
+      const std::uint64_t epoch                 = internal::next_visit_epoch();
+      size_t cursor                             = entry.positions_begin;
+
+      for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+      {
+         if (node->visit_epoch_ == epoch)
+         {
+            continue;
+         }
+
+         node->visit_epoch_ = epoch;
+
+         std::vector<std::shared_ptr<hyperedge<T>>>& node_edges = node->incident_edges_;
+         const size_t count                                     = undo_positions_[cursor++];
+
+         for (size_t occurrence = 0; occurrence < count; ++occurrence)
+         {
+            node_edges.insert(node_edges.begin() + undo_positions_[cursor++], edge);
+         }
+      }
+
+      edges_.restore(entry.edge, edge, entry.position);
+
+      for (hypergraph_observer<T>* observer : observers_)
+      {
+         observer->on_edge_added(*edge);
+      }
+
+      break;
+   }
+   }
 }
 } // namespace ctl
@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <initializer_list>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <ctl/handle.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/internal/thread_pool.hpp>
+
+namespace ctl
+{
+// Collects nodes and edges and adds them to a hypergraph in one go. Nodes are referred to by
+// their index in the builder, and edges can be given one at a time, as a CSR pair of offsets and
+// pins, or as a range of ranges of node indices. build() counts the degree of every node first,
+// so every incidence list is allocated once at its exact size, and then creates and links all
+// elements without locking a single weak pointer. Allocation and linking can be spread over
+// several threads, except that edges are linked in order when the graph has observers.
+//
+// The result is the same as adding the nodes and then the edges one by one in builder order:
+// ids, handles, iteration order and the order of every incidence list all match.
+//
+//    hypergraph_builder<T> builder;
+//    builder.add_nodes(4);
+//    builder.add_edges(offsets, pins);
+//    auto built = builder.build(graph, 8);
+//
+// Several threads can fill builders at the same time through shards. A shard made by
+// make_shard() refers to the nodes its builder had at that point by their usual indices and
+// numbers its own nodes after them. merge() then splices the shards into the builder in the given
+// order, renumbering the nodes of every shard to follow the ones before it.
+//
+//    auto shards = std::vector(threads, builder.make_shard());
+//    // thread i fills shards[i]
+//    builder.merge(shards, threads);
+template <typename T>
+class hypergraph_builder
+{
+ public:
+   using index_type = std::uint32_t;
+
+   // the handles of the added elements, in builder order
+   struct result
+   {
+      std::vector<handle<T>> nodes;
+      std::vector<handle<hyperedge<T>>> edges;
+   };
+
+   void reserve(size_t nodes, size_t edges, size_t pins);
+
+   template <typename... Args>
+   index_type add_node(Args&&... args);
+
+   // adds count default constructed nodes and returns the index of the first one
+   index_type add_nodes(size_t count);
+
+   void add_edge(std::span<const index_type> nodes);
+   void add_edge(std::initializer_list<index_type> nodes);
+
+   // adds one edge per pins[offsets[i]] ... pins[offsets[i + 1] - 1]
+   void add_edges(std::span<const size_t> offsets, std::span<const index_type> pins);
+
+   // adds one edge per element of a range of ranges of node indices
+   template <std::ranges::input_range Edges>
+   void add_edges(Edges&& edges);
+
+   // an empty builder that may refer to the nodes of this one, for another thread to fill
+   hypergraph_builder make_shard() const;
+
+   // appends the nodes and edges of every shard in order and empties the shards. The shards must
+   // have been made by this builder, and the pins are renumbered on up to thread_count threads.
+   void merge(std::span<hypergraph_builder> shards, size_t thread_count = 1);
+
+   // the nodes added to this builder, not counting those of the builder a shard was made from
+   size_t node_count() const { return nodes_.size(); }
+   size_t edge_count() const { return offsets_.size() - 1; }
+   size_t pin_count() const { return pins_.size(); }
+
+   // adds everything collected so far to graph and empties the builder. Observers of the graph
+   // are notified of every new edge, and an open transaction records the new elements.
+   result build(hypergraph<T>& graph, size_t thread_count = 1);
+
+ private:
+   // one past the largest valid node index
+   size_t index_limit() const { return shared_node_count_ + nodes_.size(); }
+   void check_node(index_type node) const;
+
+   std::vector<T> nodes_;
+   std::vector<size_t> offsets_{0};
+   std::vector<index_type> pins_;
+
+   // for a shard, the number of nodes of its builder it can refer to
+   size_t shared_node_count_ = 0;
+};
+
+template <typename T>
+void hypergraph_builder<T>::reserve(size_t nodes, size_t edges, size_t pins)
+{
+   nodes_.reserve(nodes);
+   offsets_.reserve(edges + 1);
+   pins_.reserve(pins);
+}
+
+template <typename T>
+template <typename... Args>
+typename hypergraph_builder<T>::index_type hypergraph_builder<T>::add_node(Args&&... args)
+{
+   if (index_limit() >= UINT32_MAX)
+   {
+      throw std::length_error("hypergraph_builder has run out of node indices.");
+   }
+
+   nodes_.emplace_back(std::forward<Args>(args)...);
+   return static_cast<index_type>(index_limit() - 1);
+}
+
+template <typename T>
+typename hypergraph_builder<T>::index_type hypergraph_builder<T>::add_nodes(size_t count)
+{
+   if (count > UINT32_MAX - index_limit())
+   {
+      throw std::length_error("hypergraph_builder has run out of node indices.");
+   }
+
+   const size_t first = index_limit();
+   nodes_.resize(nodes_.size() + count);
+   return static_cast<index_type>(first);
+}
+
+template <typename T>
+void hypergraph_builder<T>::add_edge(std::span<const index_type> nodes)
+{
+   for (index_type node : nodes)
+   {
+      check_node(node);
+   }
+
+   pins_.insert(pins_.end(), nodes.begin(), nodes.end());
+   offsets_.push_back(pins_.size());
+}
+
+template <typename T>
+void hypergraph_builder<T>::add_edge(std::initializer_list<index_type> nodes)
+{
+   add_edge(std::span<const index_type>(nodes.begin(), nodes.size()));
+}
+
+template <typename T>
+void hypergraph_builder<T>::add_edges(std::span<const size_t> offsets,
+                                      std::span<const index_type> pins)
+{
+   if (offsets.empty() || offsets.back() > pins.size())
+   {
+      throw std::invalid_argument("Edge offsets do not describe the given pins.");
+   }
+
+   for (size_t edge = 0; edge + 1 < offsets.size(); ++edge)
+   {
+      if (offsets[edge] > offsets[edge + 1])
+      {
+         throw std::invalid_argument("Edge offsets must not decrease.");
+      }
+   }
+
+   for (size_t pin = offsets.front(); pin < offsets.back(); ++pin)
+   {
+      check_node(pins[pin]);
+   }
+
+   const size_t shift = pins_.size() - offsets.front();
+   pins_.insert(pins_.end(), pins.begin() + offsets.front(), pins.begin() + offsets.back());
+
+   for (size_t offset : offsets.subspan(1))
+   {
+      offsets_.push_back(offset + shift);
+   }
+}
+
+template <typename T>
+template <std::ranges::input_range Edges>
+void hypergraph_builder<T>::add_edges(Edges&& edges)
+{
+   const size_t first_edge = offsets_.size();
+
+   for (auto&& edge : edges)
+   {
+      for (auto node : edge)
+      {
+         if (static_cast<size_t>(node) >= index_limit())
+         {
+            // like the other overloads, an invalid index leaves the builder unchanged
+            offsets_.resize(first_edge);
+            pins_.resize(offsets_.back());
+            throw std::out_of_range("Node index does not refer to a node of the builder.");
+         }
+
+         pins_.push_back(static_cast<index_type>(node));
+      }
+
+      offsets_.push_back(pins_.size());
+   }
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result hypergraph_builder<T>::build(hypergraph<T>& graph,
+                                                                  size_t thread_count)
+{
+   if (shared_node_count_ != 0)
+   {
+      throw std::logic_error("A shard has to be merged into its builder to be built.");
+   }
+
+   const size_t node_count = nodes_.size();
+   const size_t edge_count = offsets_.size() - 1;
+
+   // the edges of every node in edge order, by counting sort of the pins
+   std::vector<size_t> node_offsets(node_count + 1, 0);
+   std::vector<index_type> node_edges(pins_.size());
+
+   for (index_type node : pins_)
+   {
+      ++node_offsets[node + 1];
+   }
+
+   for (size_t node = 0; node < node_count; ++node)
+   {
+      node_offsets[node + 1] += node_offsets[node];
+   }
+
+   {
+      std::vector<size_t> cursor(node_offsets.begin(), node_offsets.end() - 1);
+
+      for (size_t edge = 0; edge < edge_count; ++edge)
+      {
+         for (size_t pin = offsets_[edge]; pin < offsets_[edge + 1]; ++pin)
+         {
+            node_edges[cursor[pins_[pin]]++] = static_cast<index_type>(edge);
+         }
+      }
+   }
+
+   internal::thread_pool pool(thread_count);
+   std::vector<std::shared_ptr<T>> nodes(node_count);
+   std::vector<std::shared_ptr<hyperedge<T>>> edges(edge_count);
+   const internal::pool_allocator<T> node_allocator = graph.template make_allocator<T>();
+   const internal::pool_allocator<hyperedge<T>> edge_allocator =
+      graph.template make_allocator<hyperedge<T>>();
+
+   // nothing is visible to the graph until every element has been created
+   pool.parallel_for(node_count, [&](size_t begin, size_t end)
+   {
+      for (size_t node = begin; node < end; ++node)
+      {
+         nodes[node] = std::allocate_shared<T>(node_allocator, std::move(nodes_[node]));
+      }
+   });
+
+   pool.parallel_for(edge_count, [&](size_t begin, size_t end)
+   {
+      for (size_t edge = begin; edge < end; ++edge)
+      {
+         edges[edge] = std::allocate_shared<hyperedge<T>>(edge_allocator);
+         std::vector<std::shared_ptr<T>>& edge_nodes = edges[edge]->incident_nodes_;
+         edge_nodes.reserve(offsets_[edge + 1] - offsets_[edge]);
+
+         for (size_t pin = offsets_[edge]; pin < offsets_[edge + 1]; ++pin)
+         {
+            edge_nodes.push_back(nodes[pins_[pin]]);
+         }
+      }
+   });
+
+   // ids and handles are handed out in builder order
+   result built;
+   built.nodes.reserve(node_count);
+   built.edges.reserve(edge_count);
+   graph.nodes_.reserve(graph.nodes_.size() + node_count);
+   graph.edges_.reserve(graph.edges_.size() + edge_count);
+
+   for (const std::shared_ptr<T>& node : nodes)
+   {
+      graph.insert_node(node);
+      built.nodes.push_back(node->handle_);
+   }
+
+   for (const std::shared_ptr<hyperedge<T>>& edge : edges)
+   {
+      graph.register_edge(edge);
+      built.edges.push_back(edge->handle_);
+   }
+
+   // observers expect to see every edge as soon as it is linked and before any later one is, so
+   // with observers attached the edges are linked one by one into the reserved lists
+   const bool observed = !graph.observers_.empty();
+
+   pool.parallel_for(node_count, [&](size_t begin, size_t end)
+   {
+      for (size_t node = begin; node < end; ++node)
+      {
+         std::vector<std::shared_ptr<hyperedge<T>>>& incident = nodes[node]->incident_edges_;
+         incident.reserve(node_offsets[node + 1] - node_offsets[node]);
+
+         if (observed)
+         {
+            continue;
+         }
+
+         for (size_t slot = node_offsets[node]; slot < node_offsets[node + 1]; ++slot)
+         {
+            incident.push_back(edges[node_edges[slot]]);
+         }
+      }
+   });
+
+   if (observed)
+   {
+      for (const std::shared_ptr<hyperedge<T>>& edge : edges)
+      {
+         for (const std::shared_ptr<T>& node : edge->incident_nodes_)
+         {
+            node->incident_edges_.push_back(edge);
+         }
+
+         for (hypergraph_observer<T>* observer : graph.observers_)
+         {
+            observer->on_edge_added(*edge);
+         }
+      }
+   }
+
+   nodes_.clear();
+   offsets_.assign(1, 0);
+   pins_.clear();
+   return built;
+}
+
+template <typename T>
+hypergraph_builder<T> hypergraph_builder<T>::make_shard() const
+{
+   hypergraph_builder shard;
+   shard.shared_node_count_ = index_limit();
+   return shard;
+}
+
+template <typename T>
+void hypergraph_builder<T>::merge(std::span<hypergraph_builder> shards, size_t thread_count)
+{
+   // where the nodes, edges and pins of every shard go
+   std::vector<size_t> node_starts(shards.size() + 1, index_limit());
+   std::vector<size_t> edge_starts(shards.size() + 1, edge_count());
+   std::vector<size_t> pin_starts(shards.size() + 1, pin_count());
+
+   for (size_t shard = 0; shard < shards.size(); ++shard)
+   {
+      if (shards[shard].shared_node_count_ > index_limit() || &shards[shard] == this)
+      {
+         throw std::logic_error("Shards can only be merged into the builder they were made by.");
+      }
+
+      node_starts[shard + 1] = node_starts[shard] + shards[shard].node_count();
+      edge_starts[shard + 1] = edge_starts[shard] + shards[shard].edge_count();
+      pin_starts[shard + 1]  = pin_starts[shard] + shards[shard].pin_count();
+   }
+
+   if (node_starts.back() > UINT32_MAX)
+   {
+      throw std::length_error("hypergraph_builder has run out of node indices.");
+   }
+
+   nodes_.reserve(node_starts.back() - shared_node_count_);
+
+   for (hypergraph_builder& shard : shards)
+   {
+      std::move(shard.nodes_.begin(), shard.nodes_.end(), std::back_inserter(nodes_));
+   }
+
+   offsets_.resize(edge_starts.back() + 1);
+   pins_.resize(pin_starts.back());
+
+   internal::thread_pool pool(thread_count);
+
+   pool.parallel_for(shards.size(), [&](size_t begin, size_t end)
+   {
+      for (size_t shard = begin; shard < end; ++shard)
+      {
+         const hypergraph_builder& source = shards[shard];
+         const size_t shared              = source.shared_node_count_;
+         const size_t node_shift          = node_starts[shard] - shared;
+         index_type* pins                 = pins_.data() + pin_starts[shard];
+
+         // shared nodes keep their index, the shard's own nodes follow the ones merged before
+         for (index_type node : source.pins_)
+         {
+            *pins++ = node < shared ? node : static_cast<index_type>(node + node_shift);
+         }
+
+         for (size_t edge = 1; edge < source.offsets_.size(); ++edge)
+         {
+            offsets_[edge_starts[shard] + edge] = source.offsets_[edge] + pin_starts[shard];
+         }
+      }
+   });
+
+   for (hypergraph_builder& shard : shards)
+   {
+      shard.nodes_.clear();
+      shard.offsets_.assign(1, 0);
+      shard.pins_.clear();
+   }
+}
+
+template <typename T>
+void hypergraph_builder<T>::check_node(index_type node) const
+{
+   if (node >= index_limit())
+   {
+      throw std::out_of_range("Node index does not refer to a node of the builder.");
+   }
+}
+} // namespace ctl
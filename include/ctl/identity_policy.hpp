@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <ctl/internal/identity.hpp>
+
+namespace ctl
+{
+// Identity policies decide the type of the ids carried by nodes, edges and hypergraphs and how
+// they are generated. A node type selects its policy through its node base class
+// (class Foo : public node<Foo, uuid_identity>), and its hyperedges and hypergraphs follow it.
+// Every hypergraph owns one policy instance and draws the ids of its nodes and edges from it
+// through next(). The hypergraph's own id comes from the static next_global().
+
+// Numbers the nodes and edges of a hypergraph 1, 2, 3, ... in the order they are added, so ids are
+// unique within one hypergraph. Generating an id is a single increment.
+struct monotonic_identity
+{
+   using id_type = std::uint64_t;
+
+   id_type next() { return ++last_id_; }
+
+   static id_type next_global()
+   {
+      static std::atomic<id_type> last_global_id{0};
+      return last_global_id.fetch_add(1, std::memory_order_relaxed) + 1;
+   }
+
+ private:
+   id_type last_id_ = 0;
+};
+
+// Gives every node, edge and hypergraph a random (version 4) uuid, unique across hypergraphs.
+struct uuid_identity
+{
+   using id_type = internal::uuid;
+
+   id_type next() { return internal::uuid::generate(); }
+
+   static id_type next_global() { return internal::uuid::generate(); }
+};
+} // namespace ctl
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+// Define CTL_ENABLE_INSTRUMENTATION to 1 before including any CTL header, or on the command line,
+// to count events on the hot paths of hypergraph<T>. It has to have the same value in every
+// translation unit. When it is 0 every hook is an empty inline function and the snapshot is zero.
+#ifndef CTL_ENABLE_INSTRUMENTATION
+#define CTL_ENABLE_INSTRUMENTATION 0
+#endif
+
+namespace ctl
+{
+inline constexpr bool instrumentation_enabled = CTL_ENABLE_INSTRUMENTATION != 0;
+
+// the operations whose latency is recorded, adjacency queries being all ways of listing or
+// counting the nodes adjacent to a node or the edges adjacent to an edge
+enum class instrumented_operation
+{
+   add_edge,
+   remove_edge,
+   remove_node,
+   adjacency_query,
+};
+
+inline constexpr size_t instrumented_operation_count = 4;
+
+// Bucket 0 counts operations that took less than a nanosecond and bucket i those that took
+// [2^(i-1), 2^i) nanoseconds. The last bucket also holds everything slower.
+struct latency_histogram
+{
+   static constexpr size_t bucket_count = 40;
+
+   std::array<std::uint64_t, bucket_count> buckets{};
+   std::uint64_t count             = 0;
+   std::uint64_t total_nanoseconds = 0;
+};
+
+// The counters of every hypergraph in the process since the start or the last reset. Node and
+// edge allocations are those made through the allocators of hypergraphs, in either storage mode.
+// Scan comparisons count the elements visited by linear searches and erasures in incidence lists.
+struct instrumentation_stats
+{
+   std::uint64_t allocations      = 0;
+   std::uint64_t deallocations    = 0;
+   std::uint64_t pointer_locks    = 0;
+   std::uint64_t scan_comparisons = 0;
+   std::array<latency_histogram, instrumented_operation_count> latencies{};
+
+   const latency_histogram& latency(instrumented_operation operation) const
+   {
+      return latencies[static_cast<size_t>(operation)];
+   }
+};
+
+namespace internal
+{
+enum class instrumented_counter
+{
+   allocations,
+   deallocations,
+   pointer_locks,
+   scan_comparisons,
+};
+
+// Process-wide counters, updated with relaxed atomics. Snapshots taken while other threads work
+// are not a consistent cut, but every counter in them is exact.
+struct instrumentation_state
+{
+   std::array<std::atomic<std::uint64_t>, 4> counters{};
+   std::array<std::array<std::atomic<std::uint64_t>, latency_histogram::bucket_count>,
+              instrumented_operation_count>
+      buckets{};
+   std::array<std::atomic<std::uint64_t>, instrumented_operation_count> counts{};
+   std::array<std::atomic<std::uint64_t>, instrumented_operation_count> totals{};
+};
+
+inline instrumentation_state& get_instrumentation_state()
+{
+   static instrumentation_state state;
+   return state;
+}
+
+inline void count_event([[maybe_unused]] instrumented_counter counter,
+                        [[maybe_unused]] std::uint64_t amount = 1)
+{
+   if constexpr (instrumentation_enabled)
+   {
+      get_instrumentation_state().counters[static_cast<size_t>(counter)].fetch_add(
+         amount, std::memory_order_relaxed);
+   }
+}
+
+// records the time from its construction to its destruction as one operation
+class timed_operation
+{
+ public:
+   explicit timed_operation(instrumented_operation operation)
+      : operation_(static_cast<size_t>(operation)), start_(std::chrono::steady_clock::now())
+   {
+   }
+
+   timed_operation(const timed_operation&)            = delete;
+   timed_operation& operator=(const timed_operation&) = delete;
+
+   ~timed_operation()
+   {
+      const std::uint64_t nanoseconds = static_cast<std::uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              start_)
+            .count());
+      const size_t bucket =
+         std::min<size_t>(std::bit_width(nanoseconds), latency_histogram::bucket_count - 1);
+
+      instrumentation_state& state = get_instrumentation_state();
+      state.buckets[operation_][bucket].fetch_add(1, std::memory_order_relaxed);
+      state.counts[operation_].fetch_add(1, std::memory_order_relaxed);
+      state.totals[operation_].fetch_add(nanoseconds, std::memory_order_relaxed);
+   }
+
+ private:
+   size_t operation_;
+   std::chrono::steady_clock::time_point start_;
+};
+
+struct untimed_operation
+{
+   explicit constexpr untimed_operation(instrumented_operation) {}
+};
+
+// declare one as a local variable to time the rest of the scope
+using operation_timer =
+   std::conditional_t<instrumentation_enabled, timed_operation, untimed_operation>;
+} // namespace internal
+
+// the current counters, all zero when instrumentation is disabled
+inline instrumentation_stats instrumentation_snapshot()
+{
+   instrumentation_stats stats;
+
+   if constexpr (instrumentation_enabled)
+   {
+      const internal::instrumentation_state& state = internal::get_instrumentation_state();
+      auto load = [](const std::atomic<std::uint64_t>& value)
+      { return value.load(std::memory_order_relaxed); };
+
+      stats.allocations      = load(state.counters[0]);
+      stats.deallocations    = load(state.counters[1]);
+      stats.pointer_locks    = load(state.counters[2]);
+      stats.scan_comparisons = load(state.counters[3]);
+
+      for (size_t operation = 0; operation < instrumented_operation_count; ++operation)
+      {
+         latency_histogram& histogram = stats.latencies[operation];
+         histogram.count              = load(state.counts[operation]);
+         histogram.total_nanoseconds  = load(state.totals[operation]);
+
+         for (size_t bucket = 0; bucket < latency_histogram::bucket_count; ++bucket)
+         {
+            histogram.buckets[bucket] = load(state.buckets[operation][bucket]);
+         }
+      }
+   }
+
+   return stats;
+}
+
+inline void reset_instrumentation()
+{
+   if constexpr (instrumentation_enabled)
+   {
+      internal::instrumentation_state& state = internal::get_instrumentation_state();
+      auto clear = [](std::atomic<std::uint64_t>& value)
+      { value.store(0, std::memory_order_relaxed); };
+
+      for (auto& counter : state.counters)
+      {
+         clear(counter);
+      }
+
+      for (size_t operation = 0; operation < instrumented_operation_count; ++operation)
+      {
+         clear(state.counts[operation]);
+         clear(state.totals[operation]);
+
+         for (auto& bucket : state.buckets[operation])
+         {
+            clear(bucket);
+         }
+      }
+   }
+}
+} // namespace ctl
@@ -0,0 +1,550 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+namespace ctl::internal
+{
+struct hash128
+{
+   uint64_t low  = 0;
+   uint64_t high = 0;
+
+   auto operator<=>(const hash128&) const = default;
+};
+
+// the splitmix64 finalizer
+inline uint64_t mix64(uint64_t value)
+{
+   value ^= value >> 30;
+   value *= 0xbf58476d1ce4e5b9ULL;
+   value ^= value >> 27;
+   value *= 0x94d049bb133111ebULL;
+   value ^= value >> 31;
+   return value;
+}
+
+inline uint64_t hash_combine(uint64_t seed, uint64_t value)
+{
+   return mix64(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// A hypergraph over the nodes 0..node_count-1 whose edges are ordered tuples carrying a colour,
+// stored in CSR form. This is the input of canonicalize.
+struct coloured_hypergraph
+{
+   size_t node_count = 0;
+   std::vector<uint32_t> edge_colours;
+   std::vector<size_t> edge_offsets{0};
+   std::vector<uint32_t> edge_nodes;
+
+   size_t edge_count() const { return edge_colours.size(); }
+
+   template <typename Range>
+   void add_edge(uint32_t colour, const Range& nodes)
+   {
+      edge_colours.push_back(colour);
+      edge_nodes.insert(edge_nodes.end(), std::begin(nodes), std::end(nodes));
+      edge_offsets.push_back(edge_nodes.size());
+   }
+};
+
+// The canonical labelling of a coloured_hypergraph. Two inputs are isomorphic, by a bijection of
+// their nodes that preserves edge colours and the order of nodes within each edge, exactly when
+// their codes are equal.
+struct canonical_form
+{
+   // node -> canonical label
+   std::vector<uint32_t> labels;
+
+   // the node count, then colour, arity and labels of every edge in ascending order
+   std::vector<uint32_t> code;
+
+   hash128 hash() const
+   {
+      hash128 hash{0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+
+      for (uint32_t word : code)
+      {
+         hash.low  = hash_combine(hash.low, word);
+         hash.high = hash_combine(hash.high, word);
+      }
+
+      return hash;
+   }
+};
+
+// relabels the edges of graph and lists them in ascending order of colour, arity and labels
+inline std::vector<uint32_t> encode_canonical(const coloured_hypergraph& graph,
+                                              const std::vector<uint32_t>& labels)
+{
+   const size_t edge_count = graph.edge_count();
+   std::vector<uint32_t> relabelled(graph.edge_nodes.size());
+
+   for (size_t pin = 0; pin < relabelled.size(); ++pin)
+   {
+      relabelled[pin] = labels[graph.edge_nodes[pin]];
+   }
+
+   auto edge_nodes = [&](size_t edge)
+   {
+      return std::make_pair(relabelled.begin() + graph.edge_offsets[edge],
+                            relabelled.begin() + graph.edge_offsets[edge + 1]);
+   };
+
+   std::vector<size_t> order(edge_count);
+   std::iota(order.begin(), order.end(), 0);
+   std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs)
+   {
+      const size_t lhs_arity = graph.edge_offsets[lhs + 1] - graph.edge_offsets[lhs];
+      const size_t rhs_arity = graph.edge_offsets[rhs + 1] - graph.edge_offsets[rhs];
+
+      if (graph.edge_colours[lhs] != graph.edge_colours[rhs] || lhs_arity != rhs_arity)
+      {
+         return std::tie(graph.edge_colours[lhs], lhs_arity) <
+                std::tie(graph.edge_colours[rhs], rhs_arity);
+      }
+
+      auto [lhs_begin, lhs_end] = edge_nodes(lhs);
+      auto [rhs_begin, rhs_end] = edge_nodes(rhs);
+      return std::lexicographical_compare(lhs_begin, lhs_end, rhs_begin, rhs_end);
+   });
+
+   std::vector<uint32_t> code;
+   code.reserve(1 + 2 * edge_count + relabelled.size());
+   code.push_back(static_cast<uint32_t>(graph.node_count));
+
+   for (size_t edge : order)
+   {
+      auto [begin, end] = edge_nodes(edge);
+      code.push_back(graph.edge_colours[edge]);
+      code.push_back(static_cast<uint32_t>(end - begin));
+      code.insert(code.end(), begin, end);
+   }
+
+   return code;
+}
+
+// Finds the canonical labelling of a connected coloured_hypergraph by colour refinement and
+// individualization. Every leaf of the search tree is a discrete partition, i.e. a labelling, and
+// the one with the smallest code is canonical. Leaves with equal codes yield automorphisms, which
+// prune branches whose first node lies in the orbit of one already explored, and abandon the rest
+// of a subtree that has been shown equivalent to one explored before.
+class canonical_search
+{
+ public:
+   explicit canonical_search(const coloured_hypergraph& graph) : graph_(graph) {}
+
+   canonical_form run()
+   {
+      search(std::vector<uint32_t>(graph_.node_count, 0));
+      return canonical_form{std::move(best_labels_), std::move(best_code_)};
+   }
+
+ private:
+   static constexpr size_t no_backtrack = SIZE_MAX;
+
+   // splits cells until every node of a cell sees the same multiset of edge colours, positions
+   // and neighbouring cells. Colours are cell ranks: a cell of colour c spans [c, c + size) in the
+   // node order, so splitting a cell never changes the colour of any other cell.
+   void refine(std::vector<uint32_t>& colours) const
+   {
+      const size_t node_count = graph_.node_count;
+      std::vector<uint64_t> signatures(node_count);
+      std::vector<uint32_t> order(node_count);
+      size_t cell_count = count_cells(colours);
+
+      while (cell_count < node_count)
+      {
+         std::fill(signatures.begin(), signatures.end(), 0);
+
+         for (size_t edge = 0; edge < graph_.edge_count(); ++edge)
+         {
+            const size_t begin = graph_.edge_offsets[edge];
+            const size_t end   = graph_.edge_offsets[edge + 1];
+            uint64_t edge_hash = hash_combine(graph_.edge_colours[edge], end - begin);
+
+            for (size_t pin = begin; pin < end; ++pin)
+            {
+               edge_hash = hash_combine(edge_hash, colours[graph_.edge_nodes[pin]]);
+            }
+
+            // summing keeps the signature independent of the order incidences are visited in
+            for (size_t pin = begin; pin < end; ++pin)
+            {
+               signatures[graph_.edge_nodes[pin]] += mix64(hash_combine(edge_hash, pin - begin));
+            }
+         }
+
+         std::iota(order.begin(), order.end(), 0);
+         std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+         {
+            return std::tie(colours[lhs], signatures[lhs]) <
+                   std::tie(colours[rhs], signatures[rhs]);
+         });
+
+         std::vector<uint32_t> refined(node_count);
+         size_t refined_cell_count = 1;
+
+         for (size_t i = 1; i < node_count; ++i)
+         {
+            const uint32_t previous = order[i - 1];
+            const uint32_t current  = order[i];
+
+            if (colours[previous] == colours[current] &&
+                signatures[previous] == signatures[current])
+            {
+               refined[current] = refined[previous];
+            }
+            else
+            {
+               refined[current] = static_cast<uint32_t>(i);
+               ++refined_cell_count;
+            }
+         }
+
+         if (refined_cell_count == cell_count)
+         {
+            break;
+         }
+
+         colours.swap(refined);
+         cell_count = refined_cell_count;
+      }
+   }
+
+   static size_t count_cells(const std::vector<uint32_t>& colours)
+   {
+      std::vector<bool> seen(colours.size(), false);
+      size_t cell_count = 0;
+
+      for (uint32_t colour : colours)
+      {
+         if (!seen[colour])
+         {
+            seen[colour] = true;
+            ++cell_count;
+         }
+      }
+
+      return cell_count;
+   }
+
+   size_t search(std::vector<uint32_t> colours)
+   {
+      refine(colours);
+
+      // the first cell with more than one node is the one to individualize
+      std::vector<uint32_t> cell_sizes(graph_.node_count, 0);
+
+      for (uint32_t colour : colours)
+      {
+         ++cell_sizes[colour];
+      }
+
+      auto target = std::find_if(cell_sizes.begin(), cell_sizes.end(),
+                                 [](uint32_t size) { return size > 1; });
+
+      if (target == cell_sizes.end())
+      {
+         return leaf(colours);
+      }
+
+      const uint32_t target_colour = static_cast<uint32_t>(target - cell_sizes.begin());
+      const size_t depth           = path_.size();
+      std::vector<uint32_t> tried;
+
+      for (uint32_t node = 0; node < graph_.node_count; ++node)
+      {
+         if (colours[node] != target_colour || is_pruned(node, tried))
+         {
+            continue;
+         }
+
+         std::vector<uint32_t> individualized = colours;
+
+         for (uint32_t other_node = 0; other_node < graph_.node_count; ++other_node)
+         {
+            if (other_node != node && colours[other_node] == target_colour)
+            {
+               individualized[other_node] = target_colour + 1;
+            }
+         }
+
+         tried.push_back(node);
+         path_.push_back(node);
+         const size_t backtrack = search(std::move(individualized));
+         path_.pop_back();
+
+         if (backtrack < depth)
+         {
+            return backtrack;
+         }
+      }
+
+      return no_backtrack;
+   }
+
+   size_t leaf(const std::vector<uint32_t>& labels)
+   {
+      std::vector<uint32_t> code = encode_canonical(graph_, labels);
+
+      if (best_code_.empty() || code < best_code_)
+      {
+         best_labels_ = labels;
+         best_code_   = std::move(code);
+         best_path_   = path_;
+         return no_backtrack;
+      }
+
+      if (code != best_code_)
+      {
+         return no_backtrack;
+      }
+
+      // mapping every node to the node with the same label in the best leaf is an automorphism.
+      // It maps this leaf's subtree at the level where the paths diverge onto one explored before.
+      std::vector<uint32_t> by_label(graph_.node_count);
+
+      for (uint32_t node = 0; node < graph_.node_count; ++node)
+      {
+         by_label[best_labels_[node]] = node;
+      }
+
+      std::vector<uint32_t>& automorphism = automorphisms_.emplace_back(graph_.node_count);
+
+      for (uint32_t node = 0; node < graph_.node_count; ++node)
+      {
+         automorphism[node] = by_label[labels[node]];
+      }
+
+      return static_cast<size_t>(
+         std::mismatch(path_.begin(), path_.end(), best_path_.begin(), best_path_.end()).first -
+         path_.begin());
+   }
+
+   // whether node is in the orbit of a tried node under the automorphisms fixing the current path
+   bool is_pruned(uint32_t node, const std::vector<uint32_t>& tried) const
+   {
+      if (tried.empty() || automorphisms_.empty())
+      {
+         return false;
+      }
+
+      std::vector<uint32_t> parents(graph_.node_count);
+      std::iota(parents.begin(), parents.end(), 0);
+
+      auto find_root = [&parents](uint32_t element)
+      {
+         while (parents[element] != element)
+         {
+            element = parents[element] = parents[parents[element]];
+         }
+
+         return element;
+      };
+
+      for (const std::vector<uint32_t>& automorphism : automorphisms_)
+      {
+         const bool fixes_path = std::all_of(path_.begin(), path_.end(), [&](uint32_t fixed)
+         {
+            return automorphism[fixed] == fixed;
+         });
+
+         if (!fixes_path)
+         {
+            continue;
+         }
+
+         for (uint32_t element = 0; element < graph_.node_count; ++element)
+         {
+            parents[find_root(element)] = find_root(automorphism[element]);
+         }
+      }
+
+      const uint32_t root = find_root(node);
+      return std::any_of(tried.begin(), tried.end(),
+                         [&](uint32_t tried_node) { return find_root(tried_node) == root; });
+   }
+
+   const coloured_hypergraph& graph_;
+   std::vector<uint32_t> path_;
+   std::vector<uint32_t> best_path_;
+   std::vector<uint32_t> best_labels_;
+   std::vector<uint32_t> best_code_;
+   std::vector<std::vector<uint32_t>> automorphisms_;
+};
+
+// Computes the canonical form of graph. Connected components are labelled independently and
+// then numbered consecutively in the order of their codes, which keeps the search small for the
+// many identical components that are typical of rewriting states.
+inline canonical_form canonicalize(const coloured_hypergraph& graph)
+{
+   const size_t node_count = graph.node_count;
+   std::vector<uint32_t> parents(node_count);
+   std::iota(parents.begin(), parents.end(), 0);
+
+   auto find_root = [&parents](uint32_t element)
+   {
+      while (parents[element] != element)
+      {
+         element = parents[element] = parents[parents[element]];
+      }
+
+      return element;
+   };
+
+   for (size_t edge = 0; edge < graph.edge_count(); ++edge)
+   {
+      for (size_t pin = graph.edge_offsets[edge] + 1; pin < graph.edge_offsets[edge + 1]; ++pin)
+      {
+         parents[find_root(graph.edge_nodes[pin])] = find_root(graph.edge_nodes[pin - 1]);
+      }
+   }
+
+   // node -> component, and node -> index within its component
+   std::vector<uint32_t> components(node_count);
+   std::vector<uint32_t> local_indices(node_count);
+   std::vector<uint32_t> root_components(node_count, UINT32_MAX);
+   std::vector<coloured_hypergraph> subgraphs;
+
+   for (uint32_t node = 0; node < node_count; ++node)
+   {
+      uint32_t& component = root_components[find_root(node)];
+
+      if (component == UINT32_MAX)
+      {
+         component = static_cast<uint32_t>(subgraphs.size());
+         subgraphs.emplace_back();
+      }
+
+      components[node]    = component;
+      local_indices[node] = static_cast<uint32_t>(subgraphs[component].node_count++);
+   }
+
+   if (subgraphs.size() <= 1)
+   {
+      return canonical_search(graph).run();
+   }
+
+   std::vector<uint32_t> local_nodes;
+
+   for (size_t edge = 0; edge < graph.edge_count(); ++edge)
+   {
+      const size_t begin = graph.edge_offsets[edge];
+      const size_t end   = graph.edge_offsets[edge + 1];
+
+      if (begin == end)
+      {
+         continue;
+      }
+
+      local_nodes.clear();
+
+      for (size_t pin = begin; pin < end; ++pin)
+      {
+         local_nodes.push_back(local_indices[graph.edge_nodes[pin]]);
+      }
+
+      subgraphs[components[graph.edge_nodes[begin]]].add_edge(graph.edge_colours[edge],
+                                                               local_nodes);
+   }
+
+   std::vector<canonical_form> component_forms;
+   component_forms.reserve(subgraphs.size());
+
+   for (const coloured_hypergraph& subgraph : subgraphs)
+   {
+      component_forms.push_back(canonical_search(subgraph).run());
+   }
+
+   std::vector<uint32_t> order(subgraphs.size());
+   std::iota(order.begin(), order.end(), 0);
+   std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs)
+   {
+      return component_forms[lhs].code < component_forms[rhs].code;
+   });
+
+   std::vector<uint32_t> offsets(subgraphs.size());
+   uint32_t offset = 0;
+
+   for (uint32_t component : order)
+   {
+      offsets[component] = offset;
+      offset += static_cast<uint32_t>(subgraphs[component].node_count);
+   }
+
+   canonical_form form;
+   form.labels.resize(node_count);
+
+   for (uint32_t node = 0; node < node_count; ++node)
+   {
+      form.labels[node] =
+         offsets[components[node]] + component_forms[components[node]].labels[local_indices[node]];
+   }
+
+   form.code = encode_canonical(graph, form.labels);
+   return form;
+}
+
+// the coloured hypergraph of a rewriting rule: left-hand side relations get colour 0, right-hand
+// side relations colour 1. labels receives the distinct rule labels in ascending order, the node
+// of a label being its position there.
+inline coloured_hypergraph make_rule_hypergraph(const std::vector<std::vector<size_t>>& lhs,
+                                                const std::vector<std::vector<size_t>>& rhs,
+                                                std::vector<size_t>& labels)
+{
+   labels.clear();
+
+   for (const std::vector<std::vector<size_t>>* relations : {&lhs, &rhs})
+   {
+      for (const std::vector<size_t>& relation : *relations)
+      {
+         labels.insert(labels.end(), relation.begin(), relation.end());
+      }
+   }
+
+   std::sort(labels.begin(), labels.end());
+   labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+   coloured_hypergraph graph;
+   graph.node_count = labels.size();
+   std::vector<uint32_t> nodes;
+   uint32_t colour = 0;
+
+   for (const std::vector<std::vector<size_t>>* relations : {&lhs, &rhs})
+   {
+      for (const std::vector<size_t>& relation : *relations)
+      {
+         nodes.clear();
+
+         for (size_t label : relation)
+         {
+            nodes.push_back(static_cast<uint32_t>(
+               std::lower_bound(labels.begin(), labels.end(), label) - labels.begin()));
+         }
+
+         graph.add_edge(colour, nodes);
+      }
+
+      ++colour;
+   }
+
+   return graph;
+}
+} // namespace ctl::internal
+
+template <>
+struct std::hash<ctl::internal::hash128>
+{
+   size_t operator()(const ctl::internal::hash128& hash) const noexcept
+   {
+      return static_cast<size_t>(hash.low ^ (hash.high * 0x9e3779b97f4a7c15ULL));
+   }
+};
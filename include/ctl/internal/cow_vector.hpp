@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace ctl::internal
+{
+// A vector with O(1) copies. Elements are stored in fixed-size chunks reached through a shared
+// directory of chunk pointers. Copies share the directory and all chunks, and the first write
+// through a copy clones the directory (one pointer per chunk) and then only the chunk holding the
+// written element, so diverging copies keep sharing everything they have not both modified.
+//
+// Reads never copy anything and a copy can be read while the vector it was taken from is being
+// written to, since a shared chunk is never modified in place.
+template <typename V, size_t ChunkSize = 64>
+class cow_vector
+{
+ public:
+   using value_type = V;
+
+   static constexpr size_t chunk_size = ChunkSize;
+
+   cow_vector() = default;
+
+   size_t size() const { return directory_ ? directory_->size : 0; }
+   bool empty() const { return size() == 0; }
+
+   const V& operator[](size_t index) const
+   {
+      return (*directory_->chunks[index / chunk_size])[index % chunk_size];
+   }
+
+   const V& at(size_t index) const
+   {
+      if (index >= size())
+      {
+         throw std::out_of_range("Index is out of range of the vector.");
+      }
+
+      return (*this)[index];
+   }
+
+   // a writable reference to an element, copying the parts of the vector that are shared first.
+   // The reference is invalidated by the next copy of the vector.
+   V& mutate(size_t index)
+   {
+      if (index >= size())
+      {
+         throw std::out_of_range("Index is out of range of the vector.");
+      }
+
+      return (*own_chunk(index / chunk_size))[index % chunk_size];
+   }
+
+   void push_back(V value)
+   {
+      own_directory();
+
+      if (directory_->size % chunk_size == 0)
+      {
+         directory_->chunks.push_back(std::make_shared<chunk>());
+         directory_->chunks.back()->reserve(chunk_size);
+      }
+
+      own_chunk(directory_->size / chunk_size)->push_back(std::move(value));
+      ++directory_->size;
+   }
+
+   // how many chunks this vector shares with at least one copy
+   size_t shared_chunk_count() const
+   {
+      if (!directory_)
+      {
+         return 0;
+      }
+
+      if (directory_.use_count() > 1)
+      {
+         return directory_->chunks.size();
+      }
+
+      size_t shared = 0;
+
+      for (const std::shared_ptr<chunk>& stored : directory_->chunks)
+      {
+         shared += stored.use_count() > 1 ? 1 : 0;
+      }
+
+      return shared;
+   }
+
+ private:
+   using chunk = std::vector<V>;
+
+   struct directory
+   {
+      std::vector<std::shared_ptr<chunk>> chunks;
+      size_t size = 0;
+   };
+
+   void own_directory()
+   {
+      if (!directory_)
+      {
+         directory_ = std::make_shared<directory>();
+      }
+      else if (directory_.use_count() > 1)
+      {
+         directory_ = std::make_shared<directory>(*directory_);
+      }
+   }
+
+   std::shared_ptr<chunk>& own_chunk(size_t chunk_index)
+   {
+      own_directory();
+      std::shared_ptr<chunk>& stored = directory_->chunks[chunk_index];
+
+      if (stored.use_count() > 1)
+      {
+         auto copy = std::make_shared<chunk>();
+         copy->reserve(chunk_size);
+         copy->assign(stored->begin(), stored->end());
+         stored = std::move(copy);
+      }
+
+      return stored;
+   }
+
+   std::shared_ptr<directory> directory_;
+};
+} // namespace ctl::internal
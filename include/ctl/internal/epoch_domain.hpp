@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace ctl::internal
+{
+// Epoch-based reclamation for one writer and a bounded number of readers. Each reader owns a slot
+// on its own cache line. Entering a critical section copies the global epoch into the slot and
+// leaving resets it, so the read path is two stores and a load with no shared writes.
+//
+// The writer retires an object by first unpublishing it and then calling advance(), which
+// returns the epoch the object was retired in. A reader that could still see the object entered
+// in that epoch or earlier, so the object can be freed once min_active() is larger.
+class epoch_domain
+{
+ public:
+   static constexpr uint64_t idle = UINT64_MAX;
+
+   explicit epoch_domain(size_t max_readers)
+      : slots_(std::make_unique<slot[]>(max_readers)), slot_count_(max_readers)
+   {
+   }
+
+   epoch_domain(const epoch_domain&)            = delete;
+   epoch_domain& operator=(const epoch_domain&) = delete;
+
+   // claims a free reader slot
+   size_t acquire_slot()
+   {
+      for (size_t index = 0; index < slot_count_; ++index)
+      {
+         bool expected = false;
+
+         if (slots_[index].owned.compare_exchange_strong(expected, true,
+                                                         std::memory_order_acquire))
+         {
+            return index;
+         }
+      }
+
+      throw std::length_error("All reader slots of the epoch domain are in use.");
+   }
+
+   void release_slot(size_t index)
+   {
+      slots_[index].epoch.store(idle, std::memory_order_release);
+      slots_[index].owned.store(false, std::memory_order_release);
+   }
+
+   void enter(size_t index) noexcept
+   {
+      slots_[index].epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+   }
+
+   void leave(size_t index) noexcept
+   {
+      slots_[index].epoch.store(idle, std::memory_order_release);
+   }
+
+   // starts a new epoch and returns the one that ended
+   uint64_t advance() { return epoch_.fetch_add(1, std::memory_order_seq_cst); }
+
+   uint64_t get_epoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+   // the oldest epoch a reader is currently in, or idle if no reader is inside
+   uint64_t min_active() const
+   {
+      uint64_t oldest = idle;
+
+      for (size_t index = 0; index < slot_count_; ++index)
+      {
+         oldest = std::min(oldest, slots_[index].epoch.load(std::memory_order_seq_cst));
+      }
+
+      return oldest;
+   }
+
+ private:
+   struct alignas(64) slot
+   {
+      std::atomic<uint64_t> epoch{idle};
+      std::atomic<bool> owned{false};
+   };
+
+   std::unique_ptr<slot[]> slots_;
+   size_t slot_count_;
+   std::atomic<uint64_t> epoch_{1};
+};
+} // namespace ctl::internal
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ranges>
+
+#include <ctl/hypergraph.hpp>
+
+namespace ctl::internal
+{
+// exposes a hypergraph to the matcher through raw pointers. They are only held while the graph is
+// not being modified, so no reference counts are touched during matching.
+template <typename T>
+class hypergraph_access
+{
+ public:
+   using node_type = const T*;
+   using edge_type = const hyperedge<T>*;
+
+   explicit hypergraph_access(const hypergraph<T>& graph) : graph_(graph) {}
+
+   auto edges() const
+   {
+      return graph_.edges() | std::views::transform([](const hyperedge<T>& edge) { return &edge; });
+   }
+
+   auto incident_edges(node_type node) const
+   {
+      return node->incident_edges() |
+             std::views::transform([](const hyperedge<T>& edge) { return &edge; });
+   }
+
+   size_t arity(edge_type edge) const { return std::ranges::size(edge->incident_nodes()); }
+
+   node_type node_at(edge_type edge, size_t position) const
+   {
+      return &edge->incident_nodes()[position];
+   }
+
+ private:
+   const hypergraph<T>& graph_;
+};
+} // namespace ctl::internal
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <random>
@@ -61,11 +63,12 @@ class uuid
       return ss.str();
    }
 
+   // the generator is seeded once per thread, so only the first uuid on a thread touches the
+   // system entropy source
    static const uuid generate()
    {
       uuid uuid;
-      std::random_device random_device;
-      std::mt19937 generator(random_device());
+      thread_local std::mt19937_64 generator(std::random_device{}());
       std::uniform_int_distribution<size_t> distribution(0, UINT64_MAX);
 
       uuid.most_significant_bits_  = distribution(generator);
@@ -140,22 +143,39 @@ class uuid
    }
 };
 
+// Holds the id of a node, edge or hypergraph. The id type and how ids are generated is decided by
+// an identity policy (see ctl/identity_policy.hpp). Nodes and edges start out with a
+// value-initialized id and receive their real one when they are added to a hypergraph.
+template <typename Policy>
 class identity
 {
  public:
-   identity() : uuid_(uuid::generate()) {}
+   using id_type = typename Policy::id_type;
+
+   identity() : id_() {}
+   explicit identity(const id_type& id) : id_(id) {}
    virtual ~identity() {}
    identity(const identity& rhs) = default;
    identity& operator=(const identity& rhs) = default;
    identity(identity&& rhs)                 = default;
    identity& operator=(identity&& rhs)      = default;
 
-   bool operator==(const identity& rhs) const { return uuid_ == rhs.uuid_; }
-   bool operator!=(const identity& rhs) const { return uuid_ == rhs.uuid_; }
+   bool operator==(const identity& rhs) const { return id_ == rhs.id_; }
+   bool operator!=(const identity& rhs) const { return id_ != rhs.id_; }
 
-   //const uuid get_uuid() const { return uuid_; }
+   const id_type& get_id() const { return id_; }
 
  protected:
-   uuid uuid_;
+   id_type id_;
+};
+} // namespace ctl::internal
+
+template <>
+struct std::hash<ctl::internal::uuid>
+{
+   size_t operator()(const ctl::internal::uuid& value) const noexcept
+   {
+      // the version and variant bits are fixed, the remaining bits are uniformly random
+      return static_cast<size_t>(value.get_msb() ^ (value.get_lsb() * 0x9E3779B97F4A7C15ull));
+   }
 };
-}
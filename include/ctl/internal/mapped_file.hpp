@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CTL_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CTL_HAS_MMAP 0
+#endif
+
+namespace ctl::internal
+{
+// The contents of a file as a read-only byte range. Where POSIX mmap is available the file is
+// mapped, so opening it costs no reads and pages are loaded on first access. Elsewhere the whole
+// file is read into a buffer. Either way the bytes are aligned to at least 16.
+class mapped_file
+{
+ public:
+   mapped_file() = default;
+
+   explicit mapped_file(const std::filesystem::path& path)
+   {
+#if CTL_HAS_MMAP
+      const int descriptor = ::open(path.c_str(), O_RDONLY);
+
+      if (descriptor < 0)
+      {
+         throw std::system_error(errno, std::generic_category(), "Cannot open " + path.string());
+      }
+
+      struct stat status;
+
+      if (::fstat(descriptor, &status) != 0)
+      {
+         const int error = errno;
+         ::close(descriptor);
+         throw std::system_error(error, std::generic_category(), "Cannot stat " + path.string());
+      }
+
+      size_ = static_cast<size_t>(status.st_size);
+
+      if (size_ != 0)
+      {
+         void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+         if (mapping == MAP_FAILED)
+         {
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "Cannot map " + path.string());
+         }
+
+         data_ = static_cast<const std::byte*>(mapping);
+      }
+
+      // the mapping stays valid without the descriptor
+      ::close(descriptor);
+#else
+      std::ifstream stream(path, std::ios::binary | std::ios::ate);
+
+      if (!stream)
+      {
+         throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory),
+                                 "Cannot open " + path.string());
+      }
+
+      size_   = static_cast<size_t>(stream.tellg());
+      buffer_ = std::make_unique<std::byte[]>(size_);
+      stream.seekg(0);
+
+      if (!stream.read(reinterpret_cast<char*>(buffer_.get()), static_cast<std::streamsize>(size_)))
+      {
+         throw std::system_error(std::make_error_code(std::errc::io_error),
+                                 "Cannot read " + path.string());
+      }
+
+      data_ = buffer_.get();
+#endif
+   }
+
+   mapped_file(const mapped_file&)            = delete;
+   mapped_file& operator=(const mapped_file&) = delete;
+
+   mapped_file(mapped_file&& rhs) noexcept
+      : data_(std::exchange(rhs.data_, nullptr)), size_(std::exchange(rhs.size_, 0)),
+        buffer_(std::move(rhs.buffer_))
+   {
+   }
+
+   mapped_file& operator=(mapped_file&& rhs) noexcept
+   {
+      if (this != &rhs)
+      {
+         unmap();
+         data_   = std::exchange(rhs.data_, nullptr);
+         size_   = std::exchange(rhs.size_, 0);
+         buffer_ = std::move(rhs.buffer_);
+      }
+
+      return *this;
+   }
+
+   ~mapped_file() { unmap(); }
+
+   std::span<const std::byte> bytes() const { return std::span<const std::byte>(data_, size_); }
+
+   bool is_mapped() const { return data_ != nullptr && !buffer_; }
+
+ private:
+   void unmap()
+   {
+#if CTL_HAS_MMAP
+      if (is_mapped())
+      {
+         ::munmap(const_cast<std::byte*>(data_), size_);
+      }
+#endif
+      data_ = nullptr;
+      size_ = 0;
+      buffer_.reset();
+   }
+
+   const std::byte* data_ = nullptr;
+   size_t size_           = 0;
+   std::unique_ptr<std::byte[]> buffer_;
+};
+} // namespace ctl::internal
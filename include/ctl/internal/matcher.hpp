@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <ctl/rule.h>
+
+namespace ctl::internal
+{
+// The left-hand side of a rule compiled for matching. Labels are renumbered into dense slots in
+// order of first appearance (left-hand side first, then labels only the right-hand side uses), and
+// for every relation a search order is precomputed that starts at that relation and then always
+// continues with a relation sharing an already bound label, so candidates can be taken from the
+// incidence list of a bound node instead of from the whole graph.
+class match_plan
+{
+ public:
+   static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+   struct step
+   {
+      size_t relation; // index into the left-hand side
+      size_t anchor;   // position of an already bound label in the relation, or npos
+   };
+
+   match_plan() = default;
+
+   explicit match_plan(const cnr::Rule& rule)
+   {
+      if (rule.first.empty())
+      {
+         throw std::invalid_argument("The left-hand side of a rule must not be empty.");
+      }
+
+      std::vector<size_t> labels;
+
+      auto to_slots = [&labels](const cnr::AbstractRelationList& relations)
+      {
+         std::vector<std::vector<size_t>> slot_relations;
+         slot_relations.reserve(relations.size());
+
+         for (const cnr::AbstractRelation& relation : relations)
+         {
+            std::vector<size_t>& slot_relation = slot_relations.emplace_back();
+            slot_relation.reserve(relation.size());
+
+            for (size_t label : relation)
+            {
+               auto iter = std::find(labels.begin(), labels.end(), label);
+
+               if (iter == labels.end())
+               {
+                  iter = labels.insert(labels.end(), label);
+               }
+
+               slot_relation.push_back(static_cast<size_t>(iter - labels.begin()));
+            }
+         }
+
+         return slot_relations;
+      };
+
+      lhs_              = to_slots(rule.first);
+      lhs_slot_count_   = labels.size();
+      rhs_              = to_slots(rule.second);
+      total_slot_count_ = labels.size();
+
+      orders_.reserve(lhs_.size());
+
+      for (size_t start = 0; start < lhs_.size(); ++start)
+      {
+         orders_.push_back(make_order(start));
+      }
+   }
+
+   const std::vector<std::vector<size_t>>& get_lhs() const { return lhs_; }
+   const std::vector<std::vector<size_t>>& get_rhs() const { return rhs_; }
+
+   // slots bound by a match, and slots including the fresh nodes the right-hand side creates
+   size_t lhs_slot_count() const { return lhs_slot_count_; }
+   size_t total_slot_count() const { return total_slot_count_; }
+
+   const std::vector<step>& get_order(size_t start_relation) const
+   {
+      return orders_[start_relation];
+   }
+
+ private:
+   std::vector<step> make_order(size_t start) const
+   {
+      std::vector<step> order;
+      std::vector<bool> visited(lhs_.size(), false);
+      std::vector<bool> bound(lhs_slot_count_, false);
+
+      auto visit = [&](size_t relation, size_t anchor)
+      {
+         order.push_back(step{relation, anchor});
+         visited[relation] = true;
+
+         for (size_t slot : lhs_[relation])
+         {
+            bound[slot] = true;
+         }
+      };
+
+      visit(start, npos);
+
+      while (order.size() < lhs_.size())
+      {
+         size_t best_relation = npos;
+         size_t best_anchor   = npos;
+         size_t best_bound    = 0;
+
+         for (size_t relation = 0; relation < lhs_.size(); ++relation)
+         {
+            if (visited[relation])
+            {
+               continue;
+            }
+
+            size_t bound_count = 0;
+            size_t anchor      = npos;
+
+            for (size_t position = 0; position < lhs_[relation].size(); ++position)
+            {
+               if (bound[lhs_[relation][position]])
+               {
+                  ++bound_count;
+                  anchor = anchor == npos ? position : anchor;
+               }
+            }
+
+            if (best_relation == npos || bound_count > best_bound)
+            {
+               best_relation = relation;
+               best_anchor   = anchor;
+               best_bound    = bound_count;
+            }
+         }
+
+         visit(best_relation, best_anchor);
+      }
+
+      return order;
+   }
+
+   std::vector<std::vector<size_t>> lhs_;
+   std::vector<std::vector<size_t>> rhs_;
+   size_t lhs_slot_count_   = 0;
+   size_t total_slot_count_ = 0;
+   std::vector<std::vector<step>> orders_;
+};
+
+// A match of a rule's left-hand side: edges[i] matched relation i and nodes[s] is bound to slot s.
+// Distinct labels may bind the same node, but every relation matches a distinct edge.
+template <typename Edge, typename Node>
+struct match
+{
+   std::vector<Edge> edges;
+   std::vector<Node> nodes;
+};
+
+// Enumerates the matches of a match_plan in a graph through an accessor providing
+//    using edge_type / node_type   cheap, equality comparable references to edges and nodes
+//    edges()                       a range over all edges
+//    incident_edges(node)          a range over the edges containing node, listing an edge once
+//                                  per occurrence of node with repeats adjacent to each other
+//    arity(edge), node_at(edge, i) the ordered nodes of an edge
+// Callbacks receive the current match and return false to stop the enumeration.
+template <typename Access>
+class matcher
+{
+ public:
+   using edge_type  = typename Access::edge_type;
+   using node_type  = typename Access::node_type;
+   using match_type = match<edge_type, node_type>;
+
+   matcher(const match_plan& plan, const Access& access) : plan_(plan), access_(access) {}
+
+   template <typename Callback>
+   bool for_each_match(Callback&& callback) const
+   {
+      match_type current = make_match();
+      return extend(plan_.get_order(0), 0, current, callback);
+   }
+
+   // enumerates the matches whose first edge in the search order is one of first_edges. Splitting
+   // access.edges() into consecutive ranges gives the matches of for_each_match in the same order.
+   template <typename Range, typename Callback>
+   bool for_each_match_starting_in(Range&& first_edges, Callback&& callback) const
+   {
+      const std::vector<step_type>& order = plan_.get_order(0);
+      match_type current                  = make_match();
+
+      for (edge_type edge : first_edges)
+      {
+         if (try_bind(order[0].relation, edge, current))
+         {
+            const bool proceed = extend(order, 1, current, callback);
+            unbind(order[0].relation, current);
+
+            if (!proceed)
+            {
+               return false;
+            }
+         }
+      }
+
+      return true;
+   }
+
+   // enumerates only the matches that use edge, which is tried at every relation it fits
+   template <typename Callback>
+   bool for_each_match_containing(edge_type edge, Callback&& callback) const
+   {
+      match_type current = make_match();
+
+      for (size_t relation = 0; relation < plan_.get_lhs().size(); ++relation)
+      {
+         const std::vector<step_type>& order = plan_.get_order(relation);
+
+         if (try_bind(relation, edge, current))
+         {
+            const bool proceed = extend(order, 1, current, callback);
+            unbind(relation, current);
+
+            if (!proceed)
+            {
+               return false;
+            }
+         }
+      }
+
+      return true;
+   }
+
+ private:
+   using step_type = match_plan::step;
+
+   match_type make_match() const
+   {
+      match_type current;
+      current.edges.assign(plan_.get_lhs().size(), edge_type{});
+      current.nodes.assign(plan_.lhs_slot_count(), node_type{});
+      bound_.assign(plan_.lhs_slot_count(), 0);
+      used_.assign(plan_.get_lhs().size(), false);
+      return current;
+   }
+
+   template <typename Callback>
+   bool extend(const std::vector<step_type>& order, size_t depth, match_type& current,
+               Callback& callback) const
+   {
+      if (depth == order.size())
+      {
+         return callback(static_cast<const match_type&>(current));
+      }
+
+      const step_type& step = order[depth];
+      bool has_previous     = false;
+      edge_type previous{};
+
+      auto try_candidate = [&](edge_type candidate)
+      {
+         // an edge containing the anchor node several times is listed once per occurrence
+         if (has_previous && candidate == previous)
+         {
+            return true;
+         }
+
+         has_previous = true;
+         previous     = candidate;
+
+         if (!try_bind(step.relation, candidate, current))
+         {
+            return true;
+         }
+
+         const bool proceed = extend(order, depth + 1, current, callback);
+         unbind(step.relation, current);
+         return proceed;
+      };
+
+      if (step.anchor != match_plan::npos)
+      {
+         const node_type anchor_node = current.nodes[plan_.get_lhs()[step.relation][step.anchor]];
+
+         for (edge_type candidate : access_.incident_edges(anchor_node))
+         {
+            if (!try_candidate(candidate))
+            {
+               return false;
+            }
+         }
+      }
+      else
+      {
+         for (edge_type candidate : access_.edges())
+         {
+            if (!try_candidate(candidate))
+            {
+               return false;
+            }
+         }
+      }
+
+      return true;
+   }
+
+   bool try_bind(size_t relation, edge_type edge, match_type& current) const
+   {
+      const std::vector<size_t>& slots = plan_.get_lhs()[relation];
+
+      if (access_.arity(edge) != slots.size())
+      {
+         return false;
+      }
+
+      for (size_t other = 0; other < used_.size(); ++other)
+      {
+         if (used_[other] && current.edges[other] == edge)
+         {
+            return false;
+         }
+      }
+
+      size_t position = 0;
+
+      for (; position < slots.size(); ++position)
+      {
+         const node_type node = access_.node_at(edge, position);
+         const size_t slot    = slots[position];
+
+         if (bound_[slot] != 0)
+         {
+            if (current.nodes[slot] != node)
+            {
+               break;
+            }
+
+            ++bound_[slot];
+         }
+         else
+         {
+            current.nodes[slot] = node;
+            bound_[slot]        = 1;
+         }
+      }
+
+      if (position != slots.size())
+      {
+         release_slots(slots, position);
+         return false;
+      }
+
+      current.edges[relation] = edge;
+      used_[relation]         = true;
+      return true;
+   }
+
+   void unbind(size_t relation, match_type& current) const
+   {
+      const std::vector<size_t>& slots = plan_.get_lhs()[relation];
+      release_slots(slots, slots.size());
+      current.edges[relation] = edge_type{};
+      used_[relation]         = false;
+   }
+
+   // slot bindings are reference counted so that a slot bound by several relations (or several
+   // times by one relation) is only released by the last of them
+   void release_slots(const std::vector<size_t>& slots, size_t count) const
+   {
+      for (size_t position = 0; position < count; ++position)
+      {
+         --bound_[slots[position]];
+      }
+   }
+
+   const match_plan& plan_;
+   const Access& access_;
+   mutable std::vector<std::uint32_t> bound_;
+   mutable std::vector<bool> used_;
+};
+} // namespace ctl::internal
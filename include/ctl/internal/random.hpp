@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ctl::internal
+{
+// A splitmix64 generator. Unlike the standard distributions, which are implementation defined,
+// every value it draws is the same on every platform and standard library, so seeded inputs can
+// be reproduced across builds.
+class random_stream
+{
+ public:
+   explicit random_stream(std::uint64_t seed) : state_(seed) {}
+
+   // a stream for one of many independent blocks of work drawn from the same seed
+   random_stream(std::uint64_t seed, std::uint64_t block)
+      : state_(seed ^ finalize(block + 0x9e3779b97f4a7c15ULL))
+   {
+   }
+
+   std::uint64_t next()
+   {
+      state_ += 0x9e3779b97f4a7c15ULL;
+      return finalize(state_);
+   }
+
+   // a uniform value in [0, bound), which must not be 0, by Lemire's multiply and reject method
+   std::uint32_t below(std::uint32_t bound)
+   {
+      std::uint64_t product = (next() >> 32) * bound;
+
+      if (static_cast<std::uint32_t>(product) < bound)
+      {
+         const std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+
+         while (static_cast<std::uint32_t>(product) < threshold)
+         {
+            product = (next() >> 32) * bound;
+         }
+      }
+
+      return static_cast<std::uint32_t>(product >> 32);
+   }
+
+   // a uniform value in [0, 1)
+   double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+ private:
+   static std::uint64_t finalize(std::uint64_t value)
+   {
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+      return value ^ (value >> 31);
+   }
+
+   std::uint64_t state_;
+};
+} // namespace ctl::internal
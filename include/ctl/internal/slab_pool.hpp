@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <ctl/instrumentation.hpp>
+#include <ctl/internal/threading.hpp>
+
+namespace ctl::internal
+{
+// A reference counted arena that hands out small blocks carved from large chunks. Freed blocks
+// are kept on per-size free lists and reused, and the chunks themselves are only returned to the
+// system when the pool is destroyed. Every live block holds a reference on the pool, so blocks
+// that outlive their owner (e.g. shared_ptr control blocks kept alive by weak references) remain
+// valid until they are released.
+class slab_pool
+{
+ public:
+   static constexpr size_t granularity    = alignof(std::max_align_t);
+   static constexpr size_t max_block_size = 1024;
+   static constexpr size_t min_chunk_size = 64 * 1024;
+   static constexpr size_t max_chunk_size = 16 * 1024 * 1024;
+
+   slab_pool(const slab_pool&)            = delete;
+   slab_pool& operator=(const slab_pool&) = delete;
+   slab_pool(slab_pool&&)                 = delete;
+   slab_pool& operator=(slab_pool&&)      = delete;
+
+   // creates a pool holding a single reference owned by the caller
+   static slab_pool* create() { return new slab_pool(); }
+
+   void retain() noexcept
+   {
+      lock();
+      ++references_;
+      unlock();
+   }
+
+   void release() noexcept
+   {
+      lock();
+      const bool last_reference = --references_ == 0;
+      unlock();
+
+      if (last_reference)
+      {
+         delete this;
+      }
+   }
+
+   void* allocate(size_t bytes, size_t alignment)
+   {
+      if (!is_pooled(bytes, alignment))
+      {
+         return ::operator new(bytes, std::align_val_t{alignment});
+      }
+
+      const size_t size_class = to_size_class(bytes);
+
+      lock();
+
+      void* block = free_lists_[size_class];
+
+      if (block != nullptr)
+      {
+         free_lists_[size_class] = static_cast<free_block*>(block)->next;
+      }
+      else
+      {
+         block = carve((size_class + 1) * granularity);
+      }
+
+      if (block != nullptr)
+      {
+         ++references_;
+      }
+
+      unlock();
+
+      if (block == nullptr)
+      {
+         throw std::bad_alloc();
+      }
+
+      return block;
+   }
+
+   void deallocate(void* block, size_t bytes, size_t alignment) noexcept
+   {
+      if (!is_pooled(bytes, alignment))
+      {
+         ::operator delete(block, std::align_val_t{alignment});
+         return;
+      }
+
+      const size_t size_class = to_size_class(bytes);
+
+      lock();
+      free_lists_[size_class] = new (block) free_block{free_lists_[size_class]};
+      const bool last_reference = --references_ == 0;
+      unlock();
+
+      if (last_reference)
+      {
+         delete this;
+      }
+   }
+
+   size_t get_chunk_count() const { return chunks_.size(); }
+
+   // the bytes of all chunks, live and free blocks alike
+   size_t get_reserved_bytes() const { return reserved_bytes_; }
+
+ private:
+   struct free_block
+   {
+      free_block* next;
+   };
+
+   slab_pool() = default;
+
+   ~slab_pool()
+   {
+      for (std::byte* chunk : chunks_)
+      {
+         ::operator delete(chunk);
+      }
+   }
+
+   static bool is_pooled(size_t bytes, size_t alignment)
+   {
+      return bytes != 0 && bytes <= max_block_size && alignment <= granularity;
+   }
+
+   static size_t to_size_class(size_t bytes) { return (bytes - 1) / granularity; }
+
+   // bump allocates from the current chunk, starting a new one (twice the size of the previous,
+   // up to max_chunk_size) when it is exhausted. Chunks from operator new are suitably aligned.
+   void* carve(size_t block_size)
+   {
+      if (static_cast<size_t>(chunk_end_ - chunk_cursor_) < block_size)
+      {
+         const size_t chunk_size =
+            chunks_.empty() ? min_chunk_size : std::min(next_chunk_size_, max_chunk_size);
+         std::byte* chunk = static_cast<std::byte*>(::operator new(chunk_size, std::nothrow));
+
+         if (chunk == nullptr)
+         {
+            return nullptr;
+         }
+
+         chunks_.push_back(chunk);
+         reserved_bytes_ += chunk_size;
+         chunk_cursor_    = chunk;
+         chunk_end_       = chunk + chunk_size;
+         next_chunk_size_ = chunk_size * 2;
+      }
+
+      void* block = chunk_cursor_;
+      chunk_cursor_ += block_size;
+      return block;
+   }
+
+   void lock() noexcept
+   {
+      if constexpr (single_threaded)
+      {
+         return;
+      }
+
+      while (lock_.test_and_set(std::memory_order_acquire))
+      {
+         lock_.wait(true, std::memory_order_relaxed);
+      }
+   }
+
+   void unlock() noexcept
+   {
+      if constexpr (single_threaded)
+      {
+         return;
+      }
+
+      lock_.clear(std::memory_order_release);
+      lock_.notify_one();
+   }
+
+   std::array<free_block*, max_block_size / granularity> free_lists_{};
+   std::vector<std::byte*> chunks_;
+   std::byte* chunk_cursor_ = nullptr;
+   std::byte* chunk_end_    = nullptr;
+   size_t next_chunk_size_  = min_chunk_size;
+   size_t reserved_bytes_   = 0;
+   size_t references_       = 1;
+   std::atomic_flag lock_;
+};
+
+// A minimal allocator drawing from a slab_pool. A null pool falls back to the global heap, so the
+// same allocator type serves both storage modes of a hypergraph. Its only state is the pool
+// pointer, keeping the copy stored in every shared_ptr control block small.
+template <typename T>
+class pool_allocator
+{
+   template <typename U>
+   friend class pool_allocator;
+
+ public:
+   using value_type = T;
+
+   pool_allocator() noexcept = default;
+   explicit pool_allocator(slab_pool* pool) noexcept : pool_(pool) {}
+
+   template <typename U>
+   pool_allocator(const pool_allocator<U>& rhs) noexcept : pool_(rhs.pool_)
+   {
+   }
+
+   T* allocate(size_t count)
+   {
+      count_event(instrumented_counter::allocations);
+
+      if (pool_ == nullptr)
+      {
+         return std::allocator<T>().allocate(count);
+      }
+
+      return static_cast<T*>(pool_->allocate(count * sizeof(T), alignof(T)));
+   }
+
+   void deallocate(T* pointer, size_t count) noexcept
+   {
+      count_event(instrumented_counter::deallocations);
+
+      if (pool_ == nullptr)
+      {
+         std::allocator<T>().deallocate(pointer, count);
+         return;
+      }
+
+      pool_->deallocate(pointer, count * sizeof(T), alignof(T));
+   }
+
+   template <typename U>
+   bool operator==(const pool_allocator<U>& rhs) const noexcept
+   {
+      return pool_ == rhs.pool_;
+   }
+
+ private:
+   slab_pool* pool_ = nullptr;
+};
+
+// The bytes std::allocate_shared with a pool_allocator adds around an object, assuming the layout
+// of the common standard libraries: a vtable pointer and two reference counts, followed by the
+// allocator and the object in one block.
+template <typename T>
+struct shared_block_layout
+{
+   void* vtable;
+   std::uint32_t use_count;
+   std::uint32_t weak_count;
+   pool_allocator<T> allocator;
+   T object;
+};
+
+template <typename T>
+inline constexpr size_t control_block_overhead = sizeof(shared_block_layout<T>) - sizeof(T);
+} // namespace ctl::internal
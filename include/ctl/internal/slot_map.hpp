@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ctl::internal
+{
+// A generational slot map. Values are kept densely packed in insertion order (until an erase moves
+// the last value into the vacated position), so iteration is a plain walk over a vector, while a
+// key (index + generation, see ctl::handle) addresses a slot that points at the value's current
+// position. Insertion, lookup and erasure are all O(1). A slot's generation is odd while it is
+// occupied and even while it is free, so only keys handed out by insert ever resolve.
+template <typename V, typename Key>
+class slot_map
+{
+ public:
+   using value_type     = V;
+   using key_type       = Key;
+   using iterator       = typename std::vector<V>::iterator;
+   using const_iterator = typename std::vector<V>::const_iterator;
+
+   // Takes a free slot if there is one. While erases may still be undone, reuse_erased has to be
+   // false: restore needs the slots freed by erase, so a slot vacated by undo_insert or a new one
+   // is taken instead.
+   key_type insert(V value, bool reuse_erased = true)
+   {
+      std::uint32_t slot_index;
+
+      if (reuse_erased && free_head_ != null_slot)
+      {
+         slot_index = free_head_;
+         free_head_ = slots_[slot_index].position;
+      }
+      else if (!vacated_.empty())
+      {
+         slot_index = vacated_.back();
+         vacated_.pop_back();
+      }
+      else
+      {
+         if (slots_.size() >= null_slot)
+         {
+            throw std::length_error("slot_map has run out of slot indices.");
+         }
+
+         slot_index = static_cast<std::uint32_t>(slots_.size());
+         slots_.push_back(slot{0, 0});
+      }
+
+      slots_[slot_index].position = static_cast<std::uint32_t>(values_.size());
+      slots_[slot_index].generation += 1;
+      values_.push_back(std::move(value));
+      value_slots_.push_back(slot_index);
+
+      return key_type{slot_index, slots_[slot_index].generation};
+   }
+
+   bool contains(const key_type& key) const { return position_of(key) != null_slot; }
+
+   V* find(const key_type& key)
+   {
+      const std::uint32_t position = position_of(key);
+      return position != null_slot ? &values_[position] : nullptr;
+   }
+
+   const V* find(const key_type& key) const
+   {
+      const std::uint32_t position = position_of(key);
+      return position != null_slot ? &values_[position] : nullptr;
+   }
+
+   // removes the value addressed by key by moving the last value into its position
+   bool erase(const key_type& key)
+   {
+      const std::uint32_t position = position_of(key);
+
+      if (position == null_slot)
+      {
+         return false;
+      }
+
+      const std::uint32_t last_position = static_cast<std::uint32_t>(values_.size() - 1);
+
+      if (position != last_position)
+      {
+         values_[position]                       = std::move(values_[last_position]);
+         value_slots_[position]                  = value_slots_[last_position];
+         slots_[value_slots_[position]].position = position;
+      }
+
+      values_.pop_back();
+      value_slots_.pop_back();
+
+      slot& vacated      = slots_[key.index];
+      vacated.generation = vacated.generation + 1;
+      vacated.position   = free_head_;
+      free_head_         = key.index;
+
+      return true;
+   }
+
+   // undoes the most recent insert that has not been undone yet, which must not have reused an
+   // erased slot. The values and the free list are as they were before the insert, while the
+   // slot's generation moves on like after an erase, so copies of the key stay stale for good.
+   void undo_insert(const key_type& key)
+   {
+      if (position_of(key) != values_.size() - 1)
+      {
+         throw std::logic_error("Only the most recent insert can be undone.");
+      }
+
+      values_.pop_back();
+      value_slots_.pop_back();
+      slots_[key.index].generation += 1;
+      vacated_.push_back(key.index);
+   }
+
+   // undoes the most recent erase that has not been undone yet, given the erased value and the
+   // position it had. The key resolves again and the values are back in their previous order.
+   void restore(const key_type& key, V value, size_t position)
+   {
+      if (free_head_ != key.index || slots_[key.index].generation != key.generation + 1 ||
+          position > values_.size())
+      {
+         throw std::logic_error("Only the most recent erase can be undone.");
+      }
+
+      free_head_ = slots_[key.index].position;
+
+      if (position < values_.size())
+      {
+         // erase moved the last value into position, so it goes back to the end
+         values_.push_back(std::move(values_[position]));
+         value_slots_.push_back(value_slots_[position]);
+         slots_[value_slots_.back()].position = static_cast<std::uint32_t>(values_.size() - 1);
+         values_[position]      = std::move(value);
+         value_slots_[position] = key.index;
+      }
+      else
+      {
+         values_.push_back(std::move(value));
+         value_slots_.push_back(key.index);
+      }
+
+      slots_[key.index] = slot{static_cast<std::uint32_t>(position), key.generation};
+   }
+
+   // the key of the value currently stored at position
+   key_type key_at(size_t position) const
+   {
+      const std::uint32_t slot_index = value_slots_[position];
+      return key_type{slot_index, slots_[slot_index].generation};
+   }
+
+   // the position of the value addressed by key, or size() if key is stale
+   size_t position_of_key(const key_type& key) const
+   {
+      const std::uint32_t position = position_of(key);
+      return position != null_slot ? position : values_.size();
+   }
+
+   void reserve(size_t capacity)
+   {
+      values_.reserve(capacity);
+      value_slots_.reserve(capacity);
+      slots_.reserve(capacity);
+   }
+
+   void clear()
+   {
+      while (!values_.empty())
+      {
+         erase(key_at(values_.size() - 1));
+      }
+   }
+
+   size_t size() const { return values_.size(); }
+   bool empty() const { return values_.empty(); }
+   size_t slot_count() const { return slots_.size(); }
+
+   // the bytes held by the arrays of the map, spare capacity included
+   size_t get_memory_usage() const
+   {
+      return values_.capacity() * sizeof(V) +
+             (value_slots_.capacity() + vacated_.capacity()) * sizeof(std::uint32_t) +
+             slots_.capacity() * sizeof(slot);
+   }
+
+   // releases spare capacity. Slots of erased values are kept, their generations are still needed
+   // to tell stale keys apart.
+   void shrink_to_fit()
+   {
+      values_.shrink_to_fit();
+      value_slots_.shrink_to_fit();
+      slots_.shrink_to_fit();
+      vacated_.shrink_to_fit();
+   }
+
+   const std::vector<V>& values() const { return values_; }
+
+   iterator begin() { return values_.begin(); }
+   iterator end() { return values_.end(); }
+   const_iterator begin() const { return values_.begin(); }
+   const_iterator end() const { return values_.end(); }
+
+ private:
+   static constexpr std::uint32_t null_slot = UINT32_MAX;
+
+   // position holds the index into values_ while the slot is occupied and the next free slot
+   // while it is on the free list
+   struct slot
+   {
+      std::uint32_t position;
+      std::uint32_t generation;
+   };
+
+   std::uint32_t position_of(const key_type& key) const
+   {
+      if (key.index >= slots_.size() || slots_[key.index].generation != key.generation ||
+          (key.generation & 1) == 0)
+      {
+         return null_slot;
+      }
+
+      return slots_[key.index].position;
+   }
+
+   std::vector<slot> slots_;
+   std::vector<V> values_;
+   std::vector<std::uint32_t> value_slots_;
+   std::uint32_t free_head_ = null_slot;
+
+   // free slots that no erase can be undone into, filled by undo_insert
+   std::vector<std::uint32_t> vacated_;
+};
+} // namespace ctl::internal
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ctl::internal
+{
+// Reads line-oriented text made of unsigned integers from a stream in large chunks. Numbers are
+// parsed by hand straight out of the buffer, so the stream is only touched once per chunk.
+class text_reader
+{
+ public:
+   explicit text_reader(std::istream& stream, size_t buffer_size = 1 << 20)
+      : stream_(stream), buffer_(std::max<size_t>(buffer_size, 1))
+   {
+   }
+
+   // moves to the start of the next line that is neither blank nor starts with one of the
+   // comment markers and returns false if there is none
+   bool next_content_line(std::string_view comment_markers)
+   {
+      while (true)
+      {
+         skip_spaces();
+         const int next = peek();
+
+         if (next == end_of_file)
+         {
+            return false;
+         }
+
+         if (next == '\n')
+         {
+            advance();
+            ++line_;
+         }
+         else if (comment_markers.find(static_cast<char>(next)) != std::string_view::npos)
+         {
+            skip_line();
+         }
+         else
+         {
+            return true;
+         }
+      }
+   }
+
+   // reads the next number of the current line, or returns false at the end of the line
+   bool read_integer(std::uint64_t& value)
+   {
+      skip_spaces();
+      int next = peek();
+
+      if (next == '\n' || next == end_of_file)
+      {
+         return false;
+      }
+
+      if (next < '0' || next > '9')
+      {
+         fail("expected an unsigned integer");
+      }
+
+      value = 0;
+
+      do
+      {
+         const std::uint64_t digit = static_cast<std::uint64_t>(next - '0');
+
+         if (value > (UINT64_MAX - digit) / 10)
+         {
+            fail("integer is too large");
+         }
+
+         value = value * 10 + digit;
+         advance();
+         next = peek();
+      } while (next >= '0' && next <= '9');
+
+      if (next != ' ' && next != '\t' && next != '\r' && next != '\n' && next != end_of_file)
+      {
+         fail("expected an unsigned integer");
+      }
+
+      return true;
+   }
+
+   // like read_integer, but the number has to be there
+   std::uint64_t expect_integer()
+   {
+      std::uint64_t value = 0;
+
+      if (!read_integer(value))
+      {
+         fail("expected another number");
+      }
+
+      return value;
+   }
+
+   // consumes the rest of the current line, which must be empty
+   void end_line()
+   {
+      skip_spaces();
+
+      if (peek() != '\n' && peek() != end_of_file)
+      {
+         fail("unexpected text at the end of the line");
+      }
+
+      skip_line();
+   }
+
+   void skip_line()
+   {
+      while (true)
+      {
+         const int next = peek();
+
+         if (next == end_of_file)
+         {
+            return;
+         }
+
+         advance();
+
+         if (next == '\n')
+         {
+            ++line_;
+            return;
+         }
+      }
+   }
+
+   [[noreturn]] void fail(const std::string& message) const
+   {
+      throw std::runtime_error("line " + std::to_string(line_) + ": " + message + ".");
+   }
+
+ private:
+   static constexpr int end_of_file = -1;
+
+   int peek()
+   {
+      if (position_ == size_ && !refill())
+      {
+         return end_of_file;
+      }
+
+      return static_cast<unsigned char>(buffer_[position_]);
+   }
+
+   void advance() { ++position_; }
+
+   void skip_spaces()
+   {
+      int next = peek();
+
+      while (next == ' ' || next == '\t' || next == '\r')
+      {
+         advance();
+         next = peek();
+      }
+   }
+
+   bool refill()
+   {
+      stream_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+      size_     = static_cast<size_t>(stream_.gcount());
+      position_ = 0;
+      return size_ != 0;
+   }
+
+   std::istream& stream_;
+   std::vector<char> buffer_;
+   size_t position_ = 0;
+   size_t size_     = 0;
+   size_t line_     = 1;
+};
+
+// Writes text to a stream in large chunks, formatting numbers with std::to_chars.
+class text_writer
+{
+ public:
+   explicit text_writer(std::ostream& stream, size_t buffer_size = 1 << 20)
+      : stream_(stream), buffer_(std::max<size_t>(buffer_size, 64))
+   {
+   }
+
+   text_writer(const text_writer&)            = delete;
+   text_writer& operator=(const text_writer&) = delete;
+
+   ~text_writer() { flush(); }
+
+   void write_integer(std::uint64_t value)
+   {
+      reserve(20);
+      char* first = buffer_.data() + position_;
+      position_ += std::to_chars(first, buffer_.data() + buffer_.size(), value).ptr - first;
+   }
+
+   void put(char character)
+   {
+      reserve(1);
+      buffer_[position_++] = character;
+   }
+
+   void flush()
+   {
+      stream_.write(buffer_.data(), static_cast<std::streamsize>(position_));
+      position_ = 0;
+   }
+
+   // flushes the buffer and the stream, and throws if any write has failed
+   void finish()
+   {
+      flush();
+
+      if (!stream_.flush())
+      {
+         throw std::runtime_error("Cannot write the hypergraph to the stream.");
+      }
+   }
+
+ private:
+   void reserve(size_t bytes)
+   {
+      if (buffer_.size() - position_ < bytes)
+      {
+         flush();
+      }
+   }
+
+   std::ostream& stream_;
+   std::vector<char> buffer_;
+   size_t position_ = 0;
+};
+} // namespace ctl::internal
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ctl/internal/threading.hpp>
+
+namespace ctl::internal
+{
+// A fixed set of worker threads used to split bulk work into contiguous chunks. The calling
+// thread always processes one of the chunks itself, so a pool of size 1 has no workers at all and
+// runs everything inline.
+class thread_pool
+{
+ public:
+   explicit thread_pool(size_t thread_count = default_thread_count())
+   {
+      thread_count = single_threaded ? 1 : std::max<size_t>(thread_count, 1);
+      workers_.reserve(thread_count - 1);
+
+      for (size_t i = 1; i < thread_count; ++i)
+      {
+         workers_.emplace_back([this] { work(); });
+      }
+   }
+
+   thread_pool(const thread_pool&)            = delete;
+   thread_pool& operator=(const thread_pool&) = delete;
+   thread_pool(thread_pool&&)                 = delete;
+   thread_pool& operator=(thread_pool&&)      = delete;
+
+   ~thread_pool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         stopping_ = true;
+      }
+
+      condition_.notify_all();
+
+      for (std::thread& worker : workers_)
+      {
+         worker.join();
+      }
+   }
+
+   static size_t default_thread_count()
+   {
+      if constexpr (single_threaded)
+      {
+         return 1;
+      }
+
+      return std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+   }
+
+   size_t size() const { return workers_.size() + 1; }
+
+   // calls task(begin, end) for contiguous chunks covering [0, count) and returns once all of them
+   // have finished. The first exception thrown by a chunk is rethrown to the caller.
+   template <typename Task>
+   void parallel_for(size_t count, Task&& task)
+   {
+      const size_t chunk_count = std::min(count, size());
+
+      if (chunk_count <= 1)
+      {
+         if (count != 0)
+         {
+            task(size_t{0}, count);
+         }
+
+         return;
+      }
+
+      std::vector<std::exception_ptr> errors(chunk_count);
+      std::latch done(static_cast<std::ptrdiff_t>(chunk_count - 1));
+
+      auto run_chunk = [&](size_t chunk)
+      {
+         try
+         {
+            task(chunk * count / chunk_count, (chunk + 1) * count / chunk_count);
+         }
+         catch (...)
+         {
+            errors[chunk] = std::current_exception();
+         }
+      };
+
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+
+         for (size_t chunk = 1; chunk < chunk_count; ++chunk)
+         {
+            tasks_.emplace_back([&run_chunk, &done, chunk]
+            {
+               run_chunk(chunk);
+               done.count_down();
+            });
+         }
+      }
+
+      condition_.notify_all();
+      run_chunk(0);
+      done.wait();
+
+      for (const std::exception_ptr& error : errors)
+      {
+         if (error)
+         {
+            std::rethrow_exception(error);
+         }
+      }
+   }
+
+ private:
+   void work()
+   {
+      while (true)
+      {
+         std::function<void()> task;
+
+         {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+            if (tasks_.empty())
+            {
+               return;
+            }
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+         }
+
+         task();
+      }
+   }
+
+   std::vector<std::thread> workers_;
+   std::deque<std::function<void()>> tasks_;
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   bool stopping_ = false;
+};
+} // namespace ctl::internal
@@ -0,0 +1,20 @@
+#pragma once
+
+// Define CTL_SINGLE_THREADED to 1 before including any CTL header, or on the command line, to
+// promise that CTL is only ever used from one thread at a time. cxptr then dereferences a cached
+// pointer after checking that the object is alive instead of locking it, visit epochs and slab
+// pools use no atomic operations, and thread pools run every task on the calling thread. It has
+// to have the same value in every translation unit, and concurrent_hypergraph cannot be used.
+#ifndef CTL_SINGLE_THREADED
+#define CTL_SINGLE_THREADED 0
+#endif
+
+namespace ctl::internal
+{
+inline constexpr bool single_threaded = CTL_SINGLE_THREADED != 0;
+
+// takes the place of a cached pointer where none is kept
+struct no_pointer
+{
+};
+} // namespace ctl::internal
@@ -1,13 +1,38 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <ranges>
 #include <vector>
 
 #include <ctl/cxptr.hpp>
+#include <ctl/internal/threading.hpp>
 
 namespace ctl::internal
 {
+// dereferences a shared ptr into a plain reference, used to adapt the internal storage of nodes and
+// edges into views that yield the managed objects without touching any reference counts.
+inline constexpr auto dereference = [](const auto& shared_ptr) -> auto& { return *shared_ptr; };
+
+// returns a fresh epoch for visited marking. Nodes and edges remember the epoch of the last
+// traversal that reached them, so a traversal can test and set "visited" in O(1) without clearing
+// marks afterwards or allocating a set. The counter is 64 bits wide and never wraps in practice.
+inline std::uint64_t next_visit_epoch()
+{
+   if constexpr (single_threaded)
+   {
+      static std::uint64_t epoch = 0;
+      return ++epoch;
+   }
+   else
+   {
+      static std::atomic<std::uint64_t> epoch{0};
+      return epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+   }
+}
+
 // converts a weak ptr to a shared ptr to query the given container using std::find. If the value
 // was not found or if the weak ptr could not be locked conatiner.end() is returned.
 template <typename T>
@@ -19,6 +44,8 @@ find_with_weak_ptr(std::vector<std::shared_ptr<T>>& shared_vector, const cxptr<T
    if (auto shared_ptr = value.lock())
    {
       iter = std::find(shared_vector.begin(), shared_vector.end(), shared_ptr);
+      count_event(instrumented_counter::scan_comparisons,
+                  std::min<size_t>(iter - shared_vector.begin() + 1, shared_vector.size()));
    }
 
    return iter;
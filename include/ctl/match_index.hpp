@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <ctl/handle.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/internal/hypergraph_access.hpp>
+#include <ctl/internal/matcher.hpp>
+#include <ctl/internal/slot_map.hpp>
+#include <ctl/rule.h>
+
+namespace ctl
+{
+// The set of all matches of a rule's left-hand side in a hypergraph, kept up to date as the
+// hypergraph changes. Removing an edge drops exactly the matches that used it (found through a
+// per-edge list of match handles) and adding an edge only searches for matches containing that
+// edge, so the cost of an update is proportional to the edge's neighbourhood rather than to the
+// size of the graph. The index attaches itself to the hypergraph for its whole lifetime.
+// A change that announces several edges at once, like removing a node, finds a match spanning two
+// of them from each, so a match found from an edge is only inserted if it is not indexed yet.
+template <typename T>
+class match_index : public hypergraph_observer<T>
+{
+ public:
+   using match_type = internal::match<const hyperedge<T>*, const T*>;
+
+   match_index(hypergraph<T>& graph, const cnr::Rule& rule);
+   match_index(const match_index&)            = delete;
+   match_index& operator=(const match_index&) = delete;
+   match_index(match_index&&)                 = delete;
+   match_index& operator=(match_index&&)      = delete;
+   ~match_index() override;
+
+   size_t size() const { return matches_.size(); }
+   bool empty() const { return matches_.empty(); }
+
+   // the current matches, in no particular but deterministic order
+   const std::vector<match_type>& get_matches() const { return matches_.values(); }
+
+   void on_edge_added(const hyperedge<T>& edge) override;
+   void on_edge_removed(const hyperedge<T>& edge) override;
+
+ private:
+   using key_type = handle<match_type>;
+
+   void insert(const match_type& match);
+   bool is_indexed(const match_type& match, const hyperedge<T>* found_from);
+   std::vector<key_type>& matches_of(const hyperedge<T>* edge);
+
+   hypergraph<T>& graph_;
+   internal::match_plan plan_;
+   internal::hypergraph_access<T> access_;
+   internal::slot_map<match_type, key_type> matches_;
+
+   // edge handle index -> handles of the matches using the edge
+   std::vector<std::vector<key_type>> edge_matches_;
+};
+
+template <typename T>
+match_index<T>::match_index(hypergraph<T>& graph, const cnr::Rule& rule)
+   : graph_(graph), plan_(rule), access_(graph)
+{
+   internal::matcher<internal::hypergraph_access<T>> matcher(plan_, access_);
+
+   matcher.for_each_match([this](const match_type& match)
+   {
+      insert(match);
+      return true;
+   });
+
+   graph_.attach(this);
+}
+
+template <typename T>
+match_index<T>::~match_index()
+{
+   graph_.detach(this);
+}
+
+template <typename T>
+void match_index<T>::on_edge_added(const hyperedge<T>& edge)
+{
+   internal::matcher<internal::hypergraph_access<T>> matcher(plan_, access_);
+
+   matcher.for_each_match_containing(&edge, [this, &edge](const match_type& match)
+   {
+      if (!is_indexed(match, &edge))
+      {
+         insert(match);
+      }
+
+      return true;
+   });
+}
+
+template <typename T>
+void match_index<T>::on_edge_removed(const hyperedge<T>& edge)
+{
+   std::vector<key_type> removed_matches;
+   removed_matches.swap(matches_of(&edge));
+
+   for (const key_type& key : removed_matches)
+   {
+      const match_type* match = matches_.find(key);
+
+      if (match == nullptr)
+      {
+         continue;
+      }
+
+      for (const hyperedge<T>* other_edge : match->edges)
+      {
+         if (other_edge != &edge)
+         {
+            std::erase(matches_of(other_edge), key);
+         }
+      }
+
+      matches_.erase(key);
+   }
+}
+
+template <typename T>
+void match_index<T>::insert(const match_type& match)
+{
+   const key_type key = matches_.insert(match);
+
+   for (const hyperedge<T>* edge : match.edges)
+   {
+      matches_of(edge).push_back(key);
+   }
+}
+
+// A match found from an edge is new unless an earlier announcement found it from another of its
+// edges, in which case it is listed with that edge. The matcher itself never reports a match twice.
+template <typename T>
+bool match_index<T>::is_indexed(const match_type& match, const hyperedge<T>* found_from)
+{
+   const auto other_edge = std::find_if(match.edges.begin(), match.edges.end(),
+                                        [found_from](const hyperedge<T>* edge)
+                                        { return edge != found_from; });
+
+   if (other_edge == match.edges.end())
+   {
+      return false;
+   }
+
+   for (const key_type& key : matches_of(*other_edge))
+   {
+      const match_type& indexed = *matches_.find(key);
+
+      if (indexed.edges == match.edges && indexed.nodes == match.nodes)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+template <typename T>
+std::vector<typename match_index<T>::key_type>& match_index<T>::matches_of(const hyperedge<T>* edge)
+{
+   const size_t slot = edge->get_handle().index;
+
+   if (slot >= edge_matches_.size())
+   {
+      edge_matches_.resize(slot + 1);
+   }
+
+   return edge_matches_[slot];
+}
+} // namespace ctl
@@ -0,0 +1,567 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <ctl/canonical.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/internal/matcher.hpp>
+#include <ctl/internal/thread_pool.hpp>
+#include <ctl/rule.h>
+
+namespace ctl
+{
+struct multiway_options
+{
+   // states discovered beyond this count are dropped together with the branches leading to them
+   size_t max_states = SIZE_MAX;
+
+   // false releases the edges of a state once it has been expanded, keeping only its hash and
+   // branches, so memory is dominated by the frontier rather than by the whole history
+   bool retain_expanded_states = true;
+
+   // threads expanding the frontier, including the calling thread
+   size_t thread_count = 1;
+};
+
+namespace internal
+{
+// Exposes one multiway state to the matcher. Edges are ids into the shared edge pool and nodes
+// are global node ids, so matching never copies the tuples of the state.
+class multiway_access
+{
+ public:
+   using node_type = uint32_t;
+   using edge_type = uint32_t;
+
+   multiway_access(const std::vector<size_t>& pool_offsets,
+                   const std::vector<uint32_t>& pool_nodes, std::span<const uint32_t> edges)
+      : pool_offsets_(pool_offsets), pool_nodes_(pool_nodes), edges_(edges)
+   {
+      std::vector<size_t> degrees;
+
+      for (uint32_t edge : edges_)
+      {
+         for (size_t pin = pool_offsets_[edge]; pin < pool_offsets_[edge + 1]; ++pin)
+         {
+            auto [iter, inserted] =
+               locals_.try_emplace(pool_nodes_[pin], static_cast<uint32_t>(degrees.size()));
+
+            if (inserted)
+            {
+               degrees.push_back(0);
+            }
+
+            ++degrees[iter->second];
+         }
+      }
+
+      incident_offsets_.assign(degrees.size() + 1, 0);
+
+      for (size_t node = 0; node < degrees.size(); ++node)
+      {
+         incident_offsets_[node + 1] = incident_offsets_[node] + degrees[node];
+      }
+
+      // filling in edge order keeps the repeats of an edge adjacent, as the matcher expects
+      std::vector<size_t> cursor(incident_offsets_.begin(), incident_offsets_.end() - 1);
+      incident_edges_.resize(incident_offsets_.back());
+
+      for (uint32_t edge : edges_)
+      {
+         for (size_t pin = pool_offsets_[edge]; pin < pool_offsets_[edge + 1]; ++pin)
+         {
+            incident_edges_[cursor[locals_.find(pool_nodes_[pin])->second]++] = edge;
+         }
+      }
+   }
+
+   std::span<const uint32_t> edges() const { return edges_; }
+
+   std::span<const uint32_t> incident_edges(uint32_t node) const
+   {
+      const uint32_t local = locals_.find(node)->second;
+      return std::span<const uint32_t>(incident_edges_.data() + incident_offsets_[local],
+                                       incident_offsets_[local + 1] - incident_offsets_[local]);
+   }
+
+   size_t arity(uint32_t edge) const { return pool_offsets_[edge + 1] - pool_offsets_[edge]; }
+
+   uint32_t node_at(uint32_t edge, size_t position) const
+   {
+      return pool_nodes_[pool_offsets_[edge] + position];
+   }
+
+ private:
+   const std::vector<size_t>& pool_offsets_;
+   const std::vector<uint32_t>& pool_nodes_;
+   std::span<const uint32_t> edges_;
+   std::unordered_map<uint32_t, uint32_t> locals_;
+   std::vector<size_t> incident_offsets_;
+   std::vector<uint32_t> incident_edges_;
+};
+} // namespace internal
+
+// Explores every branch of the evolution of a hypergraph under a rule. Each state is expanded by
+// applying every match of the rule's left-hand side separately, successors are deduplicated by
+// their canonical hash, and each application is recorded as a branch from the expanded state to
+// its (possibly already known) successor.
+//
+// States share structure: all edges live in one pool of node id tuples and a state is only the
+// sorted list of the pool ids of its edges, so a successor costs the ids it keeps plus the tuples
+// the right-hand side creates. Like in the underlying rewriting model, a state consists of edges
+// only, nodes exist through the edges containing them.
+template <typename T>
+class multiway_system
+{
+ public:
+   using state_id = size_t;
+
+   struct state
+   {
+      canonical_hash hash;
+      size_t generation = 0;
+
+      // sorted pool ids, empty once released
+      std::vector<uint32_t> edges;
+      bool expanded = false;
+      bool retained = true;
+   };
+
+   struct branch
+   {
+      state_id source;
+      state_id target;
+   };
+
+   multiway_system(const hypergraph<T>& initial, const cnr::Rule& rule,
+                   multiway_options options = {});
+   multiway_system(const multiway_system&)            = delete;
+   multiway_system& operator=(const multiway_system&) = delete;
+   multiway_system(multiway_system&&)                 = default;
+   multiway_system& operator=(multiway_system&&)      = default;
+   ~multiway_system()                                 = default;
+
+   // expands every state of the frontier and returns the number of new states
+   size_t step();
+
+   // expands up to generations frontiers and returns the number of new states
+   size_t run(size_t generations);
+
+   size_t state_count() const { return states_.size(); }
+   size_t get_generation() const { return generation_; }
+   const state& get_state(state_id id) const { return states_.at(id); }
+   const std::vector<branch>& get_branches() const { return branches_; }
+   const std::vector<state_id>& get_frontier() const { return frontier_; }
+   std::optional<state_id> find_state(const canonical_hash& hash) const;
+
+   // the edges of a retained state as tuples of global node ids
+   std::vector<std::vector<uint32_t>> get_state_edges(state_id id) const;
+
+   // builds a standalone hypergraph of a retained state
+   hypergraph<T> materialize(state_id id) const;
+
+ private:
+   // a successor as prepared by a worker: the kept pool ids plus the new tuples in CSR form, whose
+   // fresh nodes are placeholders counting down from UINT32_MAX until the successor is stored
+   struct successor
+   {
+      state_id source;
+      std::vector<uint32_t> kept_edges;
+      std::vector<size_t> created_offsets{0};
+      std::vector<uint32_t> created_nodes;
+      canonical_hash hash;
+   };
+
+   void expand(state_id id, std::vector<successor>& successors) const;
+   void assign_fresh_nodes(successor& next);
+   state_id store(successor& next);
+   canonical_hash hash_state(const std::vector<uint32_t>& kept_edges,
+                             const std::vector<size_t>& created_offsets,
+                             const std::vector<uint32_t>& created_nodes) const;
+   uint32_t append_edge(std::span<const uint32_t> nodes);
+   void compact_pool();
+
+   internal::match_plan plan_;
+   multiway_options options_;
+   std::unique_ptr<internal::thread_pool> thread_pool_;
+
+   // the shared edge pool
+   std::vector<size_t> pool_offsets_{0};
+   std::vector<uint32_t> pool_nodes_;
+   uint32_t next_node_id_ = 0;
+
+   std::vector<state> states_;
+   std::vector<branch> branches_;
+   std::vector<state_id> frontier_;
+   std::unordered_map<canonical_hash, state_id> index_;
+   size_t generation_ = 0;
+};
+
+template <typename T>
+multiway_system<T>::multiway_system(const hypergraph<T>& initial, const cnr::Rule& rule,
+                                    multiway_options options)
+   : plan_(rule), options_(options),
+     thread_pool_(std::make_unique<internal::thread_pool>(options.thread_count))
+{
+   std::unordered_map<handle<T>, uint32_t> node_ids;
+
+   for (const T& node : initial.nodes())
+   {
+      node_ids.emplace(node.get_handle(), next_node_id_++);
+   }
+
+   successor initial_state;
+   initial_state.source = 0;
+
+   for (const hyperedge<T>& edge : initial.edges())
+   {
+      for (const T& node : edge.incident_nodes())
+      {
+         initial_state.created_nodes.push_back(node_ids.at(node.get_handle()));
+      }
+
+      initial_state.created_offsets.push_back(initial_state.created_nodes.size());
+   }
+
+   initial_state.hash =
+      hash_state({}, initial_state.created_offsets, initial_state.created_nodes);
+   frontier_.push_back(store(initial_state));
+}
+
+template <typename T>
+size_t multiway_system<T>::step()
+{
+   if (frontier_.empty())
+   {
+      return 0;
+   }
+
+   // matching and hashing only read the pool, so the frontier is expanded concurrently and the
+   // successors are stored afterwards in frontier and match order, independent of thread count
+   std::vector<std::vector<successor>> successors(frontier_.size());
+
+   thread_pool_->parallel_for(frontier_.size(), [&](size_t begin, size_t end)
+   {
+      for (size_t i = begin; i < end; ++i)
+      {
+         expand(frontier_[i], successors[i]);
+      }
+   });
+
+   std::vector<state_id> next_frontier;
+
+   for (std::vector<successor>& state_successors : successors)
+   {
+      for (successor& next : state_successors)
+      {
+         auto found = index_.find(next.hash);
+         state_id target;
+
+         if (found != index_.end())
+         {
+            target = found->second;
+         }
+         else if (states_.size() < options_.max_states)
+         {
+            assign_fresh_nodes(next);
+            target = store(next);
+            next_frontier.push_back(target);
+         }
+         else
+         {
+            continue;
+         }
+
+         branches_.push_back(branch{next.source, target});
+      }
+   }
+
+   for (state_id id : frontier_)
+   {
+      states_[id].expanded = true;
+
+      if (!options_.retain_expanded_states)
+      {
+         states_[id].retained = false;
+         std::vector<uint32_t>().swap(states_[id].edges);
+      }
+   }
+
+   if (!options_.retain_expanded_states)
+   {
+      compact_pool();
+   }
+
+   frontier_.swap(next_frontier);
+   ++generation_;
+   return frontier_.size();
+}
+
+template <typename T>
+size_t multiway_system<T>::run(size_t generations)
+{
+   size_t discovered = 0;
+
+   for (size_t generation = 0; generation < generations && !frontier_.empty(); ++generation)
+   {
+      discovered += step();
+   }
+
+   return discovered;
+}
+
+template <typename T>
+std::optional<typename multiway_system<T>::state_id>
+multiway_system<T>::find_state(const canonical_hash& hash) const
+{
+   auto found = index_.find(hash);
+   return found != index_.end() ? std::optional<state_id>(found->second) : std::nullopt;
+}
+
+template <typename T>
+std::vector<std::vector<uint32_t>> multiway_system<T>::get_state_edges(state_id id) const
+{
+   const state& found = states_.at(id);
+
+   if (!found.retained)
+   {
+      throw std::logic_error("The edges of an expanded state have been released.");
+   }
+
+   std::vector<std::vector<uint32_t>> edges;
+   edges.reserve(found.edges.size());
+
+   for (uint32_t edge : found.edges)
+   {
+      edges.emplace_back(pool_nodes_.begin() + pool_offsets_[edge],
+                         pool_nodes_.begin() + pool_offsets_[edge + 1]);
+   }
+
+   return edges;
+}
+
+template <typename T>
+hypergraph<T> multiway_system<T>::materialize(state_id id) const
+{
+   hypergraph<T> graph;
+   std::unordered_map<uint32_t, cxptr<T>> nodes;
+
+   for (const std::vector<uint32_t>& edge : get_state_edges(id))
+   {
+      std::vector<cxptr<T>> edge_nodes;
+      edge_nodes.reserve(edge.size());
+
+      for (uint32_t node : edge)
+      {
+         auto [iter, inserted] = nodes.try_emplace(node);
+
+         if (inserted)
+         {
+            iter->second = graph.add_node();
+         }
+
+         edge_nodes.push_back(iter->second);
+      }
+
+      graph.add_edge(edge_nodes);
+   }
+
+   return graph;
+}
+
+template <typename T>
+void multiway_system<T>::expand(state_id id, std::vector<successor>& successors) const
+{
+   const std::vector<uint32_t>& edges = states_[id].edges;
+   internal::multiway_access access(pool_offsets_, pool_nodes_, edges);
+   internal::matcher<internal::multiway_access> matcher(plan_, access);
+   std::vector<uint32_t> slots;
+
+   matcher.for_each_match([&](const internal::match<uint32_t, uint32_t>& match)
+   {
+      successor& next = successors.emplace_back();
+      next.source     = id;
+      next.kept_edges.reserve(edges.size() - match.edges.size());
+
+      std::copy_if(edges.begin(), edges.end(), std::back_inserter(next.kept_edges),
+                   [&match](uint32_t edge)
+                   {
+                      return std::find(match.edges.begin(), match.edges.end(), edge) ==
+                             match.edges.end();
+                   });
+
+      slots.assign(match.nodes.begin(), match.nodes.end());
+
+      for (size_t slot = plan_.lhs_slot_count(); slot < plan_.total_slot_count(); ++slot)
+      {
+         slots.push_back(static_cast<uint32_t>(UINT32_MAX - (slot - plan_.lhs_slot_count())));
+      }
+
+      for (const std::vector<size_t>& relation : plan_.get_rhs())
+      {
+         for (size_t slot : relation)
+         {
+            next.created_nodes.push_back(slots[slot]);
+         }
+
+         next.created_offsets.push_back(next.created_nodes.size());
+      }
+
+      next.hash = hash_state(next.kept_edges, next.created_offsets, next.created_nodes);
+      return true;
+   });
+}
+
+template <typename T>
+void multiway_system<T>::assign_fresh_nodes(successor& next)
+{
+   const uint32_t fresh_count =
+      static_cast<uint32_t>(plan_.total_slot_count() - plan_.lhs_slot_count());
+
+   for (uint32_t& node : next.created_nodes)
+   {
+      if (node > UINT32_MAX - fresh_count)
+      {
+         node = next_node_id_ + (UINT32_MAX - node);
+      }
+   }
+
+   next_node_id_ += fresh_count;
+}
+
+template <typename T>
+typename multiway_system<T>::state_id multiway_system<T>::store(successor& next)
+{
+   state& stored     = states_.emplace_back();
+   stored.hash       = next.hash;
+   stored.generation = states_.size() == 1 ? 0 : states_[next.source].generation + 1;
+   stored.edges      = std::move(next.kept_edges);
+
+   for (size_t edge = 0; edge + 1 < next.created_offsets.size(); ++edge)
+   {
+      stored.edges.push_back(append_edge(
+         std::span<const uint32_t>(next.created_nodes.data() + next.created_offsets[edge],
+                                   next.created_offsets[edge + 1] - next.created_offsets[edge])));
+   }
+
+   std::sort(stored.edges.begin(), stored.edges.end());
+
+   const state_id id = states_.size() - 1;
+   index_.emplace(stored.hash, id);
+   return id;
+}
+
+template <typename T>
+canonical_hash multiway_system<T>::hash_state(const std::vector<uint32_t>& kept_edges,
+                                              const std::vector<size_t>& created_offsets,
+                                              const std::vector<uint32_t>& created_nodes) const
+{
+   std::vector<uint32_t> node_ids(created_nodes);
+
+   for (uint32_t edge : kept_edges)
+   {
+      node_ids.insert(node_ids.end(), pool_nodes_.begin() + pool_offsets_[edge],
+                      pool_nodes_.begin() + pool_offsets_[edge + 1]);
+   }
+
+   // every pin of the state, before duplicates are dropped
+   const size_t pin_count = node_ids.size();
+
+   std::sort(node_ids.begin(), node_ids.end());
+   node_ids.erase(std::unique(node_ids.begin(), node_ids.end()), node_ids.end());
+
+   auto local = [&node_ids](uint32_t node)
+   {
+      return static_cast<uint32_t>(std::lower_bound(node_ids.begin(), node_ids.end(), node) -
+                                   node_ids.begin());
+   };
+
+   internal::coloured_hypergraph graph;
+   graph.node_count = node_ids.size();
+   graph.edge_nodes.reserve(pin_count);
+
+   for (uint32_t edge : kept_edges)
+   {
+      for (size_t pin = pool_offsets_[edge]; pin < pool_offsets_[edge + 1]; ++pin)
+      {
+         graph.edge_nodes.push_back(local(pool_nodes_[pin]));
+      }
+
+      graph.edge_colours.push_back(0);
+      graph.edge_offsets.push_back(graph.edge_nodes.size());
+   }
+
+   for (size_t edge = 0; edge + 1 < created_offsets.size(); ++edge)
+   {
+      for (size_t pin = created_offsets[edge]; pin < created_offsets[edge + 1]; ++pin)
+      {
+         graph.edge_nodes.push_back(local(created_nodes[pin]));
+      }
+
+      graph.edge_colours.push_back(0);
+      graph.edge_offsets.push_back(graph.edge_nodes.size());
+   }
+
+   return internal::canonicalize(graph).hash();
+}
+
+template <typename T>
+uint32_t multiway_system<T>::append_edge(std::span<const uint32_t> nodes)
+{
+   pool_nodes_.insert(pool_nodes_.end(), nodes.begin(), nodes.end());
+   pool_offsets_.push_back(pool_nodes_.size());
+   return static_cast<uint32_t>(pool_offsets_.size() - 2);
+}
+
+// drops the pool edges no retained state refers to and renumbers the rest
+template <typename T>
+void multiway_system<T>::compact_pool()
+{
+   const size_t edge_count = pool_offsets_.size() - 1;
+   std::vector<uint32_t> remap(edge_count, UINT32_MAX);
+
+   for (const state& current : states_)
+   {
+      for (uint32_t edge : current.edges)
+      {
+         remap[edge] = 0;
+      }
+   }
+
+   std::vector<size_t> offsets{0};
+   std::vector<uint32_t> nodes;
+
+   for (size_t edge = 0; edge < edge_count; ++edge)
+   {
+      if (remap[edge] == UINT32_MAX)
+      {
+         continue;
+      }
+
+      remap[edge] = static_cast<uint32_t>(offsets.size() - 1);
+      nodes.insert(nodes.end(), pool_nodes_.begin() + pool_offsets_[edge],
+                   pool_nodes_.begin() + pool_offsets_[edge + 1]);
+      offsets.push_back(nodes.size());
+   }
+
+   // renumbering preserves the order of the ids, so the edge lists stay sorted
+   for (state& current : states_)
+   {
+      for (uint32_t& edge : current.edges)
+      {
+         edge = remap[edge];
+      }
+   }
+
+   pool_offsets_.swap(offsets);
+   pool_nodes_.swap(nodes);
+}
+} // namespace ctl
@@ -0,0 +1,472 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <ctl/event_log.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/internal/hypergraph_access.hpp>
+#include <ctl/internal/matcher.hpp>
+#include <ctl/internal/thread_pool.hpp>
+#include <ctl/match_index.hpp>
+#include <ctl/rule.h>
+
+namespace ctl
+{
+// How a rewriter finds the match for its next event. rescan searches the graph anew for every
+// event, incremental keeps a match_index up to date as edges are added and removed.
+enum class match_strategy
+{
+   rescan,
+   incremental
+};
+
+// Evolves a hypergraph by repeatedly applying a rule. A rule {lhs, rhs} is a pair of relation lists
+// over abstract labels, e.g. {{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}}. An event finds
+// edges whose ordered nodes match the left-hand side (every relation a distinct edge of the same
+// arity, equal labels bound to the same node), removes them and adds the right-hand side edges,
+// creating a default constructed node for every label that only appears on the right-hand side.
+// Matches are searched along incidence lists starting from the first relation's candidates, and
+// each step applies the first match found (or with match_strategy::incremental, the first match
+// held by the match index).
+template <typename T>
+class rewriter
+{
+ public:
+   using match_type     = internal::match<const hyperedge<T>*, const T*>;
+   using event_log_type = event_log<typename T::identity_policy::id_type>;
+
+   rewriter(hypergraph<T>& graph, const cnr::Rule& rule,
+            match_strategy strategy = match_strategy::rescan);
+   rewriter(const rewriter&)            = delete;
+   rewriter& operator=(const rewriter&) = delete;
+   rewriter(rewriter&&)                 = default;
+   rewriter& operator=(rewriter&&)      = delete;
+   ~rewriter()                          = default;
+
+   // applies a single event, returns false if the rule does not match anywhere
+   bool step();
+
+   // applies up to steps events and returns how many were applied
+   size_t run(size_t steps);
+
+   // applies a maximal set of edge-disjoint matches as one generation and returns its size. The
+   // matches are searched for and the nodes and edges of all events created concurrently on the
+   // rewriter's threads. Selecting the disjoint matches and linking the events into the graph is
+   // serial and in match order, so the result is the same as applying the selected matches one
+   // after another.
+   size_t step_generation();
+
+   // applies up to generations generations and returns the number of events applied
+   size_t run_generations(size_t generations);
+
+   // the number of threads used by step_generation, including the calling thread
+   void set_thread_count(size_t thread_count);
+
+   std::vector<match_type> find_matches() const;
+   std::optional<match_type> find_first_match() const;
+
+   // replaces the edges of a match found in the current state of the hypergraph
+   void apply(const match_type& match);
+
+   // starts recording the ids of the edges consumed and produced by every following event
+   void enable_event_log();
+
+   // the recorded events, or nullptr if the event log is not enabled
+   const event_log_type* get_event_log() const { return event_log_.get(); }
+
+   size_t get_event_count() const { return event_count_; }
+   size_t get_generation_count() const { return generation_count_; }
+   const cnr::Rule& get_rule() const { return rule_; }
+
+ private:
+   std::vector<match_type> find_matches_concurrently();
+   std::vector<match_type> select_disjoint_matches();
+   internal::thread_pool& get_thread_pool();
+
+   hypergraph<T>& graph_;
+   cnr::Rule rule_;
+   internal::match_plan plan_;
+   internal::hypergraph_access<T> access_;
+   std::unique_ptr<match_index<T>> index_;
+   std::unique_ptr<internal::thread_pool> thread_pool_;
+   std::unique_ptr<event_log_type> event_log_;
+   std::vector<typename event_log_type::id_type> consumed_ids_;
+   std::vector<typename event_log_type::id_type> produced_ids_;
+   size_t thread_count_     = internal::thread_pool::default_thread_count();
+   size_t event_count_      = 0;
+   size_t generation_count_ = 0;
+};
+
+template <typename T>
+rewriter<T>::rewriter(hypergraph<T>& graph, const cnr::Rule& rule, match_strategy strategy)
+   : graph_(graph), rule_(rule), plan_(rule), access_(graph)
+{
+   if (strategy == match_strategy::incremental)
+   {
+      index_ = std::make_unique<match_index<T>>(graph, rule);
+   }
+}
+
+template <typename T>
+bool rewriter<T>::step()
+{
+   std::optional<match_type> match = find_first_match();
+
+   if (!match)
+   {
+      return false;
+   }
+
+   apply(*match);
+   return true;
+}
+
+template <typename T>
+size_t rewriter<T>::run(size_t steps)
+{
+   size_t applied = 0;
+
+   while (applied < steps && step())
+   {
+      ++applied;
+   }
+
+   return applied;
+}
+
+template <typename T>
+size_t rewriter<T>::step_generation()
+{
+   std::vector<match_type> matches = select_disjoint_matches();
+
+   if (matches.empty())
+   {
+      return 0;
+   }
+
+   struct products
+   {
+      std::vector<std::shared_ptr<T>> nodes;
+      std::vector<std::shared_ptr<hyperedge<T>>> edges;
+   };
+
+   std::vector<products> event_products(matches.size());
+   const internal::pool_allocator<T> node_allocator = graph_.template make_allocator<T>();
+   const internal::pool_allocator<hyperedge<T>> edge_allocator =
+      graph_.template make_allocator<hyperedge<T>>();
+
+   // the graph is only read while the events are prepared
+   get_thread_pool().parallel_for(matches.size(), [&](size_t begin, size_t end)
+   {
+      std::vector<std::shared_ptr<T>> slots;
+
+      for (size_t event = begin; event < end; ++event)
+      {
+         products& created = event_products[event];
+         slots.clear();
+
+         for (const T* node : matches[event].nodes)
+         {
+            slots.push_back(*graph_.nodes_.find(node->get_handle()));
+         }
+
+         for (size_t slot = plan_.lhs_slot_count(); slot < plan_.total_slot_count(); ++slot)
+         {
+            slots.push_back(created.nodes.emplace_back(std::allocate_shared<T>(node_allocator)));
+         }
+
+         created.edges.reserve(plan_.get_rhs().size());
+
+         for (const std::vector<size_t>& relation : plan_.get_rhs())
+         {
+            std::vector<std::shared_ptr<T>> edge_nodes;
+            edge_nodes.reserve(relation.size());
+
+            for (size_t slot : relation)
+            {
+               edge_nodes.push_back(slots[slot]);
+            }
+
+            created.edges.push_back(std::allocate_shared<hyperedge<T>>(edge_allocator, edge_nodes));
+         }
+      }
+   });
+
+   for (size_t event = 0; event < matches.size(); ++event)
+   {
+      consumed_ids_.clear();
+      produced_ids_.clear();
+
+      for (const hyperedge<T>* edge : matches[event].edges)
+      {
+         if (event_log_)
+         {
+            consumed_ids_.push_back(edge->get_id());
+         }
+
+         graph_.remove_edge(edge->get_handle());
+      }
+
+      for (std::shared_ptr<T>& node : event_products[event].nodes)
+      {
+         graph_.insert_node(std::move(node));
+      }
+
+      for (std::shared_ptr<hyperedge<T>>& edge : event_products[event].edges)
+      {
+         const hyperedge<T>* inserted = edge.get();
+         graph_.insert_edge(std::move(edge));
+
+         if (event_log_)
+         {
+            produced_ids_.push_back(inserted->get_id());
+         }
+      }
+
+      if (event_log_)
+      {
+         event_log_->record(consumed_ids_, produced_ids_);
+      }
+
+      ++event_count_;
+   }
+
+   ++generation_count_;
+   return matches.size();
+}
+
+template <typename T>
+size_t rewriter<T>::run_generations(size_t generations)
+{
+   size_t applied = 0;
+
+   for (size_t generation = 0; generation < generations; ++generation)
+   {
+      const size_t events = step_generation();
+
+      if (events == 0)
+      {
+         break;
+      }
+
+      applied += events;
+   }
+
+   return applied;
+}
+
+template <typename T>
+void rewriter<T>::set_thread_count(size_t thread_count)
+{
+   thread_count_ = std::max<size_t>(thread_count, 1);
+   thread_pool_.reset();
+}
+
+template <typename T>
+void rewriter<T>::enable_event_log()
+{
+   if (!event_log_)
+   {
+      event_log_ = std::make_unique<event_log_type>();
+   }
+}
+
+template <typename T>
+internal::thread_pool& rewriter<T>::get_thread_pool()
+{
+   if (!thread_pool_)
+   {
+      thread_pool_ = std::make_unique<internal::thread_pool>(thread_count_);
+   }
+
+   return *thread_pool_;
+}
+
+template <typename T>
+std::vector<typename rewriter<T>::match_type> rewriter<T>::select_disjoint_matches()
+{
+   std::vector<match_type> selected;
+   std::vector<bool> used_edges;
+
+   // greedily taking every match that does not overlap the ones taken before leaves no match
+   // that could still be added, so the selection is maximal
+   for (match_type& match : find_matches_concurrently())
+   {
+      const bool overlaps = std::any_of(match.edges.begin(), match.edges.end(),
+         [&used_edges](const hyperedge<T>* edge)
+         {
+            const size_t slot = edge->get_handle().index;
+            return slot < used_edges.size() && used_edges[slot];
+         });
+
+      if (overlaps)
+      {
+         continue;
+      }
+
+      for (const hyperedge<T>* edge : match.edges)
+      {
+         const size_t slot = edge->get_handle().index;
+
+         if (slot >= used_edges.size())
+         {
+            used_edges.resize(slot + 1, false);
+         }
+
+         used_edges[slot] = true;
+      }
+
+      selected.push_back(std::move(match));
+   }
+
+   return selected;
+}
+
+// the matches of find_matches, in the same order. Every thread searches from a consecutive range
+// of first edges, so the ranges' matches only have to be concatenated.
+template <typename T>
+std::vector<typename rewriter<T>::match_type> rewriter<T>::find_matches_concurrently()
+{
+   internal::thread_pool& pool = get_thread_pool();
+
+   if (index_ || pool.size() == 1)
+   {
+      return find_matches();
+   }
+
+   const std::vector<std::shared_ptr<hyperedge<T>>>& edges = graph_.edges_.values();
+   std::vector<std::vector<match_type>> range_matches(pool.size());
+   auto to_pointer = [](const std::shared_ptr<hyperedge<T>>& edge)
+   { return static_cast<const hyperedge<T>*>(edge.get()); };
+
+   pool.parallel_for(range_matches.size(), [&](size_t begin, size_t end)
+   {
+      internal::matcher<internal::hypergraph_access<T>> matcher(plan_, access_);
+
+      for (size_t range = begin; range < end; ++range)
+      {
+         const size_t first = range * edges.size() / range_matches.size();
+         const size_t last  = (range + 1) * edges.size() / range_matches.size();
+         auto first_edges =
+            std::span(edges).subspan(first, last - first) | std::views::transform(to_pointer);
+
+         matcher.for_each_match_starting_in(first_edges, [&](const match_type& match)
+         {
+            range_matches[range].push_back(match);
+            return true;
+         });
+      }
+   });
+
+   std::vector<match_type> matches;
+
+   for (std::vector<match_type>& found : range_matches)
+   {
+      matches.insert(matches.end(), std::make_move_iterator(found.begin()),
+                     std::make_move_iterator(found.end()));
+   }
+
+   return matches;
+}
+
+template <typename T>
+std::vector<typename rewriter<T>::match_type> rewriter<T>::find_matches() const
+{
+   if (index_)
+   {
+      return index_->get_matches();
+   }
+
+   std::vector<match_type> matches;
+   internal::matcher<internal::hypergraph_access<T>> matcher(plan_, access_);
+
+   matcher.for_each_match([&matches](const match_type& match)
+   {
+      matches.push_back(match);
+      return true;
+   });
+
+   return matches;
+}
+
+template <typename T>
+std::optional<typename rewriter<T>::match_type> rewriter<T>::find_first_match() const
+{
+   if (index_)
+   {
+      return index_->empty() ? std::nullopt
+                             : std::optional<match_type>(index_->get_matches().front());
+   }
+
+   std::optional<match_type> first_match;
+   internal::matcher<internal::hypergraph_access<T>> matcher(plan_, access_);
+
+   matcher.for_each_match([&first_match](const match_type& match)
+   {
+      first_match = match;
+      return false;
+   });
+
+   return first_match;
+}
+
+template <typename T>
+void rewriter<T>::apply(const match_type& match)
+{
+   std::vector<cxptr<T>> slots;
+   slots.reserve(plan_.total_slot_count());
+
+   for (const T* node : match.nodes)
+   {
+      slots.push_back(graph_.get_node(node->get_handle()));
+   }
+
+   for (size_t slot = plan_.lhs_slot_count(); slot < plan_.total_slot_count(); ++slot)
+   {
+      slots.push_back(graph_.add_node());
+   }
+
+   consumed_ids_.clear();
+   produced_ids_.clear();
+
+   for (const hyperedge<T>* edge : match.edges)
+   {
+      if (event_log_)
+      {
+         consumed_ids_.push_back(edge->get_id());
+      }
+
+      graph_.remove_edge(edge->get_handle());
+   }
+
+   for (const std::vector<size_t>& relation : plan_.get_rhs())
+   {
+      std::vector<cxptr<T>> nodes;
+      nodes.reserve(relation.size());
+
+      for (size_t slot : relation)
+      {
+         nodes.push_back(slots[slot]);
+      }
+
+      cxptr<hyperedge<T>> edge = graph_.add_edge(std::move(nodes));
+
+      if (event_log_)
+      {
+         produced_ids_.push_back(edge.lock()->get_id());
+      }
+   }
+
+   if (event_log_)
+   {
+      event_log_->record(consumed_ids_, produced_ids_);
+   }
+
+   ++event_count_;
+}
+} // namespace ctl
@@ -4,6 +4,8 @@
 #include <stdexcept>
 #include <vector>
 
+#include <ctl/internal/canonical.hpp>
+
 namespace cnr
 {
 using AbstractRelation     = std::vector<size_t>;
@@ -13,6 +15,42 @@ struct Rule : public std::pair<AbstractRelationList, AbstractRelationList>
 {
    using std::pair<AbstractRelationList, AbstractRelationList>::pair;
    Rule(const std::initializer_list<AbstractRelationList>& input);
+
+   // relabels the rule canonically, so that isomorphic rules become equal
    void Canonicalize();
 };
+
+// expects exactly two relation lists, the left-hand side followed by the right-hand side
+inline Rule::Rule(const std::initializer_list<AbstractRelationList>& input)
+{
+   if (input.size() != 2)
+   {
+      throw std::invalid_argument("A rule consists of exactly two relation lists.");
+   }
+
+   first  = *input.begin();
+   second = *(input.begin() + 1);
+}
+
+// labels become 1..n in canonical order and both sides are sorted
+inline void Rule::Canonicalize()
+{
+   std::vector<size_t> labels;
+   const ctl::internal::canonical_form form =
+      ctl::internal::canonicalize(ctl::internal::make_rule_hypergraph(first, second, labels));
+
+   for (AbstractRelationList* relations : {&first, &second})
+   {
+      for (AbstractRelation& relation : *relations)
+      {
+         for (size_t& label : relation)
+         {
+            auto node = std::lower_bound(labels.begin(), labels.end(), label);
+            label     = form.labels[node - labels.begin()] + 1;
+         }
+      }
+
+      std::sort(relations->begin(), relations->end());
+   }
+}
 } // namespace cnr
@@ -0,0 +1,441 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ctl/compact_view.hpp>
+#include <ctl/hypergraph.hpp>
+#include <ctl/hypergraph_builder.hpp>
+#include <ctl/internal/text_io.hpp>
+
+namespace ctl
+{
+// Streaming readers and writers for the plain text formats of hypergraph partitioners. Readers
+// parse the stream in large chunks with a hand-rolled integer parser and feed the result straight
+// into a hypergraph_builder, writers format into a large buffer. Nodes and edges are numbered in
+// hypergraph<T>::get_nodes and get_edges order on output and in file order on input. Blank lines
+// are ignored, so edges without nodes cannot be written.
+//
+//    hMETIS (.hgr)   "edges nodes [fmt]", then one line of 1-based nodes per edge, prefixed by
+//                    the edge weight if fmt is 1 or 11, then one weight per node if fmt is 10 or
+//                    11. Lines starting with % are comments.
+//    PaToH           "base nodes edges pins [scheme [constraints]]", then one line per edge,
+//                    prefixed by its weight if scheme is 2 or 3, then constraints weights per
+//                    node if scheme is 1 or 3. Node numbers start at base (0 or 1).
+//    edge list       one line of 0-based nodes per edge, there are as many nodes as the largest
+//                    number plus one. Lines starting with # or % are comments.
+
+// Weights read from or written to the text formats, which the hypergraph itself does not store.
+// Either vector may be empty. Node weights hold constraint_count weights per node.
+struct text_weights
+{
+   std::vector<std::uint64_t> edges;
+   std::vector<std::uint64_t> nodes;
+   size_t constraint_count = 1;
+};
+
+template <typename T>
+typename hypergraph_builder<T>::result read_hmetis(std::istream& stream, hypergraph<T>& graph,
+                                                   text_weights* weights = nullptr,
+                                                   size_t thread_count = 1);
+
+template <typename T>
+void write_hmetis(const hypergraph<T>& graph, std::ostream& stream,
+                  const text_weights* weights = nullptr);
+
+template <typename T>
+typename hypergraph_builder<T>::result read_patoh(std::istream& stream, hypergraph<T>& graph,
+                                                  text_weights* weights = nullptr,
+                                                  size_t thread_count = 1);
+
+template <typename T>
+void write_patoh(const hypergraph<T>& graph, std::ostream& stream,
+                 const text_weights* weights = nullptr);
+
+template <typename T>
+typename hypergraph_builder<T>::result read_edge_list(std::istream& stream, hypergraph<T>& graph,
+                                                      size_t thread_count = 1);
+
+template <typename T>
+void write_edge_list(const hypergraph<T>& graph, std::ostream& stream);
+
+namespace internal
+{
+// the most edges reserved up front. Edge counts come from the header of the file, which can claim
+// far more edges than it holds; the edges beyond this are only allocated as they are read.
+inline constexpr size_t text_edge_reserve_limit = size_t{1} << 20;
+
+// reads the lines of edge_count edges, each optionally led by a weight, into builder
+template <typename T>
+void read_edge_lines(text_reader& reader, hypergraph_builder<T>& builder, size_t edge_count,
+                     std::uint64_t first_node, bool weighted, text_weights* weights)
+{
+   std::vector<std::uint32_t> edge_nodes;
+   const std::uint64_t node_count = builder.node_count();
+
+   for (size_t edge = 0; edge < edge_count; ++edge)
+   {
+      if (!reader.next_content_line("%"))
+      {
+         reader.fail("expected " + std::to_string(edge_count) + " edges");
+      }
+
+      if (weighted)
+      {
+         const std::uint64_t weight = reader.expect_integer();
+
+         if (weights != nullptr)
+         {
+            weights->edges.push_back(weight);
+         }
+      }
+
+      edge_nodes.clear();
+      std::uint64_t node = 0;
+
+      while (reader.read_integer(node))
+      {
+         if (node < first_node || node - first_node >= node_count)
+         {
+            reader.fail("node " + std::to_string(node) + " does not exist");
+         }
+
+         edge_nodes.push_back(static_cast<std::uint32_t>(node - first_node));
+      }
+
+      reader.end_line();
+      builder.add_edge(edge_nodes);
+   }
+}
+
+// reads count weights, one line per node
+inline void read_node_weights(text_reader& reader, size_t node_count, size_t per_node,
+                              text_weights* weights)
+{
+   for (size_t node = 0; node < node_count; ++node)
+   {
+      if (!reader.next_content_line("%"))
+      {
+         reader.fail("expected a weight for every node");
+      }
+
+      for (size_t weight = 0; weight < per_node; ++weight)
+      {
+         const std::uint64_t value = reader.expect_integer();
+
+         if (weights != nullptr)
+         {
+            weights->nodes.push_back(value);
+         }
+      }
+
+      reader.end_line();
+   }
+}
+
+// writes every edge as a line of node numbers starting at first_node, optionally led by weights
+template <typename T>
+void write_edge_lines(const compact_view<T>& view, text_writer& writer, std::uint64_t first_node,
+                      std::span<const std::uint64_t> edge_weights)
+{
+   for (std::uint32_t edge = 0; edge < view.edge_count(); ++edge)
+   {
+      std::span<const std::uint32_t> nodes = view.get_incident_nodes(edge);
+
+      if (nodes.empty())
+      {
+         throw std::invalid_argument("Edges without nodes cannot be written as text.");
+      }
+
+      if (!edge_weights.empty())
+      {
+         writer.write_integer(edge_weights[edge]);
+         writer.put(' ');
+      }
+
+      for (size_t pin = 0; pin < nodes.size(); ++pin)
+      {
+         writer.write_integer(nodes[pin] + first_node);
+         writer.put(pin + 1 < nodes.size() ? ' ' : '\n');
+      }
+   }
+}
+
+inline void write_node_weights(text_writer& writer, const text_weights& weights)
+{
+   for (size_t weight = 0; weight < weights.nodes.size(); ++weight)
+   {
+      writer.write_integer(weights.nodes[weight]);
+      writer.put((weight + 1) % weights.constraint_count == 0 ? '\n' : ' ');
+   }
+}
+
+// checks that the weights fit the graph and returns which of them are present
+inline std::pair<bool, bool> check_weights(const text_weights* weights, size_t node_count,
+                                           size_t edge_count)
+{
+   if (weights == nullptr)
+   {
+      return {false, false};
+   }
+
+   const bool edges = !weights->edges.empty();
+   const bool nodes = !weights->nodes.empty();
+
+   if ((edges && weights->edges.size() != edge_count) || weights->constraint_count == 0 ||
+       (nodes && weights->nodes.size() != node_count * weights->constraint_count))
+   {
+      throw std::invalid_argument("The weights do not match the nodes and edges of the graph.");
+   }
+
+   return {edges, nodes};
+}
+} // namespace internal
+
+template <typename T>
+typename hypergraph_builder<T>::result read_hmetis(std::istream& stream, hypergraph<T>& graph,
+                                                   text_weights* weights, size_t thread_count)
+{
+   internal::text_reader reader(stream);
+
+   if (!reader.next_content_line("%"))
+   {
+      reader.fail("expected the hMETIS header");
+   }
+
+   const std::uint64_t edge_count = reader.expect_integer();
+   const std::uint64_t node_count = reader.expect_integer();
+   std::uint64_t format           = 0;
+   reader.read_integer(format);
+   reader.end_line();
+
+   if (format != 0 && format != 1 && format != 10 && format != 11)
+   {
+      reader.fail("unknown hMETIS format " + std::to_string(format));
+   }
+
+   if (node_count >= UINT32_MAX || edge_count >= UINT32_MAX)
+   {
+      reader.fail("too many nodes or edges");
+   }
+
+   if (weights != nullptr)
+   {
+      *weights = text_weights{};
+   }
+
+   hypergraph_builder<T> builder;
+   builder.reserve(node_count, std::min<size_t>(edge_count, internal::text_edge_reserve_limit), 0);
+   builder.add_nodes(node_count);
+   internal::read_edge_lines(reader, builder, edge_count, 1, format % 10 == 1, weights);
+
+   if (format >= 10)
+   {
+      internal::read_node_weights(reader, node_count, 1, weights);
+   }
+
+   if (reader.next_content_line("%"))
+   {
+      reader.fail("unexpected text after the last hMETIS section");
+   }
+
+   return builder.build(graph, thread_count);
+}
+
+template <typename T>
+void write_hmetis(const hypergraph<T>& graph, std::ostream& stream, const text_weights* weights)
+{
+   const compact_view<T> view = graph.freeze();
+   const auto [edge_weights, node_weights] =
+      internal::check_weights(weights, view.node_count(), view.edge_count());
+
+   if (node_weights && weights->constraint_count != 1)
+   {
+      throw std::invalid_argument("hMETIS stores a single weight per node.");
+   }
+
+   internal::text_writer writer(stream);
+   writer.write_integer(view.edge_count());
+   writer.put(' ');
+   writer.write_integer(view.node_count());
+
+   if (edge_weights || node_weights)
+   {
+      writer.put(' ');
+      writer.write_integer((node_weights ? 10 : 0) + (edge_weights ? 1 : 0));
+   }
+
+   writer.put('\n');
+   internal::write_edge_lines(view, writer, 1,
+                              edge_weights ? std::span<const std::uint64_t>(weights->edges)
+                                           : std::span<const std::uint64_t>());
+
+   if (node_weights)
+   {
+      internal::write_node_weights(writer, *weights);
+   }
+
+   writer.finish();
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result read_patoh(std::istream& stream, hypergraph<T>& graph,
+                                                  text_weights* weights, size_t thread_count)
+{
+   internal::text_reader reader(stream);
+
+   if (!reader.next_content_line("%"))
+   {
+      reader.fail("expected the PaToH header");
+   }
+
+   const std::uint64_t base       = reader.expect_integer();
+   const std::uint64_t node_count = reader.expect_integer();
+   const std::uint64_t edge_count = reader.expect_integer();
+   const std::uint64_t pin_count  = reader.expect_integer();
+   std::uint64_t scheme           = 0;
+   std::uint64_t constraint_count = 1;
+
+   if (reader.read_integer(scheme))
+   {
+      reader.read_integer(constraint_count);
+   }
+
+   reader.end_line();
+
+   if (base > 1 || scheme > 3 || constraint_count == 0 || constraint_count > 1024)
+   {
+      reader.fail("invalid PaToH header");
+   }
+
+   if (node_count >= UINT32_MAX || edge_count >= UINT32_MAX)
+   {
+      reader.fail("too many nodes or edges");
+   }
+
+   if (weights != nullptr)
+   {
+      *weights                  = text_weights{};
+      weights->constraint_count = constraint_count;
+   }
+
+   hypergraph_builder<T> builder;
+   builder.reserve(node_count, std::min<size_t>(edge_count, internal::text_edge_reserve_limit), 0);
+   builder.add_nodes(node_count);
+   internal::read_edge_lines(reader, builder, edge_count, base, scheme >= 2, weights);
+
+   if (builder.pin_count() != pin_count)
+   {
+      reader.fail("the header announces " + std::to_string(pin_count) + " pins but there are " +
+                  std::to_string(builder.pin_count()));
+   }
+
+   if (scheme % 2 == 1)
+   {
+      internal::read_node_weights(reader, node_count, constraint_count, weights);
+   }
+
+   if (reader.next_content_line("%"))
+   {
+      reader.fail("unexpected text after the last PaToH section");
+   }
+
+   return builder.build(graph, thread_count);
+}
+
+template <typename T>
+void write_patoh(const hypergraph<T>& graph, std::ostream& stream, const text_weights* weights)
+{
+   const compact_view<T> view = graph.freeze();
+   const auto [edge_weights, node_weights] =
+      internal::check_weights(weights, view.node_count(), view.edge_count());
+
+   size_t pin_count = 0;
+
+   for (std::uint32_t edge = 0; edge < view.edge_count(); ++edge)
+   {
+      pin_count += view.get_incident_nodes(edge).size();
+   }
+
+   internal::text_writer writer(stream);
+
+   for (std::uint64_t value : {std::uint64_t{1}, std::uint64_t{view.node_count()},
+                               std::uint64_t{view.edge_count()}, std::uint64_t{pin_count}})
+   {
+      writer.write_integer(value);
+      writer.put(' ');
+   }
+
+   writer.write_integer((node_weights ? 1 : 0) + (edge_weights ? 2 : 0));
+
+   if (node_weights)
+   {
+      writer.put(' ');
+      writer.write_integer(weights->constraint_count);
+   }
+
+   writer.put('\n');
+   internal::write_edge_lines(view, writer, 1,
+                              edge_weights ? std::span<const std::uint64_t>(weights->edges)
+                                           : std::span<const std::uint64_t>());
+
+   if (node_weights)
+   {
+      internal::write_node_weights(writer, *weights);
+   }
+
+   writer.finish();
+}
+
+template <typename T>
+typename hypergraph_builder<T>::result read_edge_list(std::istream& stream, hypergraph<T>& graph,
+                                                      size_t thread_count)
+{
+   internal::text_reader reader(stream);
+   std::vector<size_t> offsets{0};
+   std::vector<std::uint32_t> pins;
+   std::uint64_t node_count = 0;
+
+   // the node count is only known at the end, so the edges are collected first
+   while (reader.next_content_line("#%"))
+   {
+      std::uint64_t node = 0;
+
+      while (reader.read_integer(node))
+      {
+         if (node >= UINT32_MAX - 1)
+         {
+            reader.fail("node " + std::to_string(node) + " is out of range");
+         }
+
+         pins.push_back(static_cast<std::uint32_t>(node));
+         node_count = std::max(node_count, node + 1);
+      }
+
+      reader.end_line();
+      offsets.push_back(pins.size());
+   }
+
+   hypergraph_builder<T> builder;
+   builder.reserve(node_count, offsets.size() - 1, pins.size());
+   builder.add_nodes(node_count);
+   builder.add_edges(offsets, pins);
+   return builder.build(graph, thread_count);
+}
+
+template <typename T>
+void write_edge_list(const hypergraph<T>& graph, std::ostream& stream)
+{
+   const compact_view<T> view = graph.freeze();
+   internal::text_writer writer(stream);
+   internal::write_edge_lines(view, writer, 0, {});
+   writer.finish();
+}
+} // namespace ctl
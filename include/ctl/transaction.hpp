@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdexcept>
+
+#include <ctl/hypergraph.hpp>
+
+namespace ctl
+{
+// Opens a transaction on a hypergraph for the lifetime of a scope. Unless commit() is called the
+// changes made in the meantime are rolled back when the transaction goes out of scope, including
+// when an exception leaves it. Transactions on the same hypergraph nest and must end in reverse
+// order of their creation. If the hypergraph's transaction was already ended directly through the
+// hypergraph, the destructor leaves it alone, and it never throws.
+//
+//    {
+//       transaction scope(graph);
+//       graph.remove_edge(edge);
+//       graph.add_edge({a, b});
+//       scope.commit();
+//    }
+template <typename T>
+class transaction
+{
+ public:
+   explicit transaction(hypergraph<T>& graph) : graph_(&graph)
+   {
+      graph.begin_transaction();
+      depth_ = graph.get_transaction_depth();
+   }
+
+   transaction(const transaction&)            = delete;
+   transaction& operator=(const transaction&) = delete;
+
+   ~transaction()
+   {
+      if (graph_ == nullptr || graph_->get_transaction_depth() != depth_)
+      {
+         return;
+      }
+
+      try
+      {
+         graph_->rollback_transaction();
+      }
+      catch (...)
+      {
+         // an observer threw while the changes were undone, which cannot be reported from here
+      }
+   }
+
+   void commit()
+   {
+      end()->commit_transaction();
+   }
+
+   void rollback()
+   {
+      end()->rollback_transaction();
+   }
+
+   bool is_open() const
+   {
+      return graph_ != nullptr && graph_->get_transaction_depth() >= depth_;
+   }
+
+ private:
+   hypergraph<T>* end()
+   {
+      if (graph_ == nullptr || graph_->get_transaction_depth() != depth_)
+      {
+         graph_ = nullptr;
+         throw std::logic_error("The transaction has already ended.");
+      }
+
+      hypergraph<T>* graph = graph_;
+      graph_               = nullptr;
+      return graph;
+   }
+
+   hypergraph<T>* graph_;
+   size_t depth_ = 0; // the transaction depth of the hypergraph while this one is innermost
+};
+} // namespace ctl
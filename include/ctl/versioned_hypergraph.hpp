@@ -0,0 +1,341 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <ctl/hypergraph.hpp>
+#include <ctl/internal/cow_vector.hpp>
+
+namespace ctl
+{
+// A hypergraph with O(1) snapshots. Nodes and edges are numbered by index in the order they are
+// added, removed indices are not reused, and all per-element state (node values, incidence lists
+// and the ordered nodes of every edge) lives in copy-on-write chunks. snapshot() and the copy
+// constructor only share those chunks, and a later change to either copy clones just the chunks
+// it touches: adding an edge copies the chunk holding the new edge and the chunks of its nodes.
+//
+// Snapshots are immutable values: they never observe later changes of the graph they were taken
+// from, can be kept around to backtrack to, and can be read by other threads while the original
+// is being modified (a single copy must still not be read and written concurrently).
+template <typename T>
+class versioned_hypergraph
+{
+ public:
+   using index_type = std::uint32_t;
+
+   versioned_hypergraph() = default;
+
+   // imports the nodes (with their ids and values) and edges of graph, numbering them in
+   // get_nodes and get_edges order
+   explicit versioned_hypergraph(const hypergraph<T>& graph);
+
+   versioned_hypergraph(const versioned_hypergraph&)            = default;
+   versioned_hypergraph& operator=(const versioned_hypergraph&) = default;
+   versioned_hypergraph(versioned_hypergraph&&)                 = default;
+   versioned_hypergraph& operator=(versioned_hypergraph&&)      = default;
+   ~versioned_hypergraph()                                      = default;
+
+   versioned_hypergraph snapshot() const { return *this; }
+
+   // incremented by every change, snapshots keep the version they were taken at
+   uint64_t get_version() const { return version_; }
+
+   template <typename... Args>
+   index_type add_node(Args&&... args);
+
+   // removes the node from every edge containing it, like hypergraph<T>::remove_node
+   void remove_node(index_type node);
+
+   index_type add_edge(std::span<const index_type> nodes);
+   index_type add_edge(std::initializer_list<index_type> nodes);
+   void remove_edge(index_type edge);
+
+   bool contains_node(index_type node) const;
+   bool contains_edge(index_type edge) const;
+
+   size_t node_count() const { return node_count_; }
+   size_t edge_count() const { return edge_count_; }
+
+   // one past the largest node and edge index handed out so far
+   size_t node_capacity() const { return nodes_.size(); }
+   size_t edge_capacity() const { return edges_.size(); }
+
+   const T& get_node(index_type node) const;
+
+   // a writable reference to the value of a node, valid until the graph is next copied
+   T& update_node(index_type node);
+
+   // edges are listed once per occurrence of the node, like hypergraph<T>::get_incident_edges
+   std::span<const index_type> get_incident_edges(index_type node) const;
+   std::span<const index_type> get_incident_nodes(index_type edge) const;
+
+   // the indices of all live nodes and edges in ascending order
+   std::vector<index_type> get_nodes() const;
+   std::vector<index_type> get_edges() const;
+
+   // chunks shared with other copies, a measure of how much a snapshot still has in common
+   size_t shared_chunk_count() const;
+
+ private:
+   struct node_record
+   {
+      std::optional<T> value;
+      std::vector<index_type> incident_edges;
+   };
+
+   struct edge_record
+   {
+      std::vector<index_type> nodes;
+      bool alive = true;
+   };
+
+   const node_record& live_node(index_type node) const;
+   const edge_record& live_edge(index_type edge) const;
+
+   internal::cow_vector<node_record> nodes_;
+   internal::cow_vector<edge_record> edges_;
+   size_t node_count_ = 0;
+   size_t edge_count_ = 0;
+   uint64_t version_  = 0;
+   typename T::identity_policy id_policy_;
+};
+
+template <typename T>
+versioned_hypergraph<T>::versioned_hypergraph(const hypergraph<T>& graph)
+{
+   std::unordered_map<handle<T>, index_type> indices;
+
+   for (const T& node : graph.nodes())
+   {
+      node_record record{T(node), {}};
+
+      // the copy still refers to the incident edges of the original
+      record.value->incident_edges_.clear();
+
+      indices.emplace(node.get_handle(), static_cast<index_type>(nodes_.size()));
+      nodes_.push_back(std::move(record));
+      ++node_count_;
+   }
+
+   std::vector<index_type> edge_nodes;
+
+   for (const hyperedge<T>& edge : graph.edges())
+   {
+      edge_nodes.clear();
+
+      for (const T& node : edge.incident_nodes())
+      {
+         edge_nodes.push_back(indices.at(node.get_handle()));
+      }
+
+      add_edge(edge_nodes);
+   }
+
+   id_policy_ = graph.id_policy_;
+   version_   = 0;
+}
+
+template <typename T>
+template <typename... Args>
+typename versioned_hypergraph<T>::index_type versioned_hypergraph<T>::add_node(Args&&... args)
+{
+   if (nodes_.size() >= UINT32_MAX)
+   {
+      throw std::length_error("versioned_hypergraph has run out of node indices.");
+   }
+
+   node_record record{T(std::forward<Args>(args)...), {}};
+   record.value->id_ = id_policy_.next();
+   nodes_.push_back(std::move(record));
+   ++node_count_;
+   ++version_;
+   return static_cast<index_type>(nodes_.size() - 1);
+}
+
+template <typename T>
+void versioned_hypergraph<T>::remove_node(index_type node)
+{
+   if (!contains_node(node))
+   {
+      return;
+   }
+
+   node_record& record = nodes_.mutate(node);
+
+   // an edge is listed once per occurrence of the node, later visits find nothing left to erase
+   for (index_type edge : record.incident_edges)
+   {
+      std::erase(edges_.mutate(edge).nodes, node);
+   }
+
+   record.value.reset();
+   record.incident_edges = {};
+   --node_count_;
+   ++version_;
+}
+
+template <typename T>
+typename versioned_hypergraph<T>::index_type
+versioned_hypergraph<T>::add_edge(std::span<const index_type> nodes)
+{
+   for (index_type node : nodes)
+   {
+      live_node(node);
+   }
+
+   if (edges_.size() >= UINT32_MAX)
+   {
+      throw std::length_error("versioned_hypergraph has run out of edge indices.");
+   }
+
+   const index_type edge = static_cast<index_type>(edges_.size());
+   edges_.push_back(edge_record{std::vector<index_type>(nodes.begin(), nodes.end()), true});
+
+   for (index_type node : nodes)
+   {
+      nodes_.mutate(node).incident_edges.push_back(edge);
+   }
+
+   ++edge_count_;
+   ++version_;
+   return edge;
+}
+
+template <typename T>
+typename versioned_hypergraph<T>::index_type
+versioned_hypergraph<T>::add_edge(std::initializer_list<index_type> nodes)
+{
+   return add_edge(std::span<const index_type>(nodes.begin(), nodes.size()));
+}
+
+template <typename T>
+void versioned_hypergraph<T>::remove_edge(index_type edge)
+{
+   if (!contains_edge(edge))
+   {
+      return;
+   }
+
+   edge_record& record = edges_.mutate(edge);
+
+   for (index_type node : record.nodes)
+   {
+      std::erase(nodes_.mutate(node).incident_edges, edge);
+   }
+
+   record.nodes = {};
+   record.alive = false;
+   --edge_count_;
+   ++version_;
+}
+
+template <typename T>
+bool versioned_hypergraph<T>::contains_node(index_type node) const
+{
+   return node < nodes_.size() && nodes_[node].value.has_value();
+}
+
+template <typename T>
+bool versioned_hypergraph<T>::contains_edge(index_type edge) const
+{
+   return edge < edges_.size() && edges_[edge].alive;
+}
+
+template <typename T>
+const T& versioned_hypergraph<T>::get_node(index_type node) const
+{
+   return *live_node(node).value;
+}
+
+template <typename T>
+T& versioned_hypergraph<T>::update_node(index_type node)
+{
+   live_node(node);
+   ++version_;
+   return *nodes_.mutate(node).value;
+}
+
+template <typename T>
+std::span<const typename versioned_hypergraph<T>::index_type>
+versioned_hypergraph<T>::get_incident_edges(index_type node) const
+{
+   return live_node(node).incident_edges;
+}
+
+template <typename T>
+std::span<const typename versioned_hypergraph<T>::index_type>
+versioned_hypergraph<T>::get_incident_nodes(index_type edge) const
+{
+   return live_edge(edge).nodes;
+}
+
+template <typename T>
+std::vector<typename versioned_hypergraph<T>::index_type> versioned_hypergraph<T>::get_nodes() const
+{
+   std::vector<index_type> nodes;
+   nodes.reserve(node_count_);
+
+   for (index_type node = 0; node < nodes_.size(); ++node)
+   {
+      if (nodes_[node].value)
+      {
+         nodes.push_back(node);
+      }
+   }
+
+   return nodes;
+}
+
+template <typename T>
+std::vector<typename versioned_hypergraph<T>::index_type> versioned_hypergraph<T>::get_edges() const
+{
+   std::vector<index_type> edges;
+   edges.reserve(edge_count_);
+
+   for (index_type edge = 0; edge < edges_.size(); ++edge)
+   {
+      if (edges_[edge].alive)
+      {
+         edges.push_back(edge);
+      }
+   }
+
+   return edges;
+}
+
+template <typename T>
+size_t versioned_hypergraph<T>::shared_chunk_count() const
+{
+   return nodes_.shared_chunk_count() + edges_.shared_chunk_count();
+}
+
+template <typename T>
+const typename versioned_hypergraph<T>::node_record&
+versioned_hypergraph<T>::live_node(index_type node) const
+{
+   if (!contains_node(node))
+   {
+      throw std::out_of_range("Node index does not refer to a node of the hypergraph.");
+   }
+
+   return nodes_[node];
+}
+
+template <typename T>
+const typename versioned_hypergraph<T>::edge_record&
+versioned_hypergraph<T>::live_edge(index_type edge) const
+{
+   if (!contains_edge(edge))
+   {
+      throw std::out_of_range("Edge index does not refer to an edge of the hypergraph.");
+   }
+
+   return edges_[edge];
+}
+} // namespace ctl
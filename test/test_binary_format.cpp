@@ -0,0 +1,143 @@
+#include <filesystem>
+#include <fstream>
+
+#include <ctl/binary_format.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class City : public ctl::node<City>
+{
+ public:
+   using ctl::node<City>::node;
+   explicit City(int population) : population_(population) {}
+   int population_ = 0;
+};
+
+class Block : public ctl::node<Block>
+{
+ public:
+   using ctl::node<Block>::node;
+};
+
+struct city_record
+{
+   int population;
+};
+} // namespace ctl::test
+
+template <>
+struct ctl::binary_payload<ctl::test::City>
+{
+   using type = ctl::test::city_record;
+
+   static type save(const ctl::test::City& city) { return type{city.population_}; }
+   static ctl::test::City load(const type& record) { return ctl::test::City(record.population); }
+};
+
+namespace ctl::test
+{
+class BinaryFormatTestFixture : public ::testing::Test
+{
+ public:
+   BinaryFormatTestFixture() {}
+
+   ~BinaryFormatTestFixture() {}
+
+ protected:
+   void SetUp() override
+   {
+      path_ = std::filesystem::temp_directory_path() /
+              (std::string("ctl-binary-format-") +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name());
+   }
+
+   void TearDown() override { std::filesystem::remove(path_); }
+
+   std::filesystem::path path_;
+};
+
+TEST_F(BinaryFormatTestFixture, RoundTrip)
+{
+   hypergraph<City> graph;
+   std::vector<cxptr<City>> cities;
+
+   for (int population = 0; population < 5; ++population)
+   {
+      cities.push_back(graph.add_node(population * 1000));
+   }
+
+   graph.add_edges({{cities[0], cities[1], cities[0]}, {cities[2]}, {}, {cities[4], cities[1]}});
+   graph.remove_node(cities[3]);
+   save_binary(graph, path_);
+
+   mapped_hypergraph mapped(path_);
+   const compact_view<City> view = graph.freeze();
+
+   ASSERT_EQ(mapped.node_count(), 4);
+   ASSERT_EQ(mapped.edge_count(), 4);
+   ASSERT_EQ(mapped.pin_count(), 6);
+   ASSERT_EQ(mapped.payload_size(), sizeof(city_record));
+
+   for (uint32_t node = 0; node < view.node_count(); ++node)
+   {
+      ASSERT_TRUE(std::ranges::equal(mapped.get_incident_edges(node),
+                                     view.get_incident_edges(node)));
+      ASSERT_EQ(mapped.get_payload<city_record>(node).population,
+                view.get_node(node)->population_);
+   }
+
+   for (uint32_t edge = 0; edge < view.edge_count(); ++edge)
+   {
+      ASSERT_TRUE(std::ranges::equal(mapped.get_incident_nodes(edge),
+                                     view.get_incident_nodes(edge)));
+   }
+
+   ASSERT_THROW(mapped.get_incident_nodes(4), std::out_of_range);
+   ASSERT_THROW(mapped.get_payload<int64_t>(0), std::invalid_argument);
+
+   hypergraph<City> loaded = load_binary<City>(path_, 2);
+   const compact_view<City> loaded_view = loaded.freeze();
+
+   ASSERT_EQ(loaded_view.node_count(), 4);
+   ASSERT_EQ(loaded_view.get_node(3)->population_, 4000);
+   ASSERT_TRUE(std::ranges::equal(loaded_view.get_incident_nodes(0), view.get_incident_nodes(0)));
+   ASSERT_TRUE(std::ranges::equal(loaded_view.get_incident_edges(1), view.get_incident_edges(1)));
+}
+
+TEST_F(BinaryFormatTestFixture, WithoutPayload)
+{
+   hypergraph<Block> graph;
+   auto nodes = graph.add_nodes(3);
+   graph.add_edge({nodes[2], nodes[0]});
+   save_binary(graph, path_);
+
+   mapped_hypergraph mapped(path_);
+   ASSERT_EQ(mapped.payload_size(), 0);
+   ASSERT_EQ(mapped.get_incident_nodes(0)[0], 2);
+
+   hypergraph<Block> loaded = load_binary<Block>(path_);
+   ASSERT_EQ(loaded.get_nodes().size(), 3);
+   ASSERT_EQ(loaded.get_edges()[0]->get_incident_nodes()[1]->get_id(), 1);
+}
+
+TEST_F(BinaryFormatTestFixture, RejectsInvalidFiles)
+{
+   ASSERT_THROW(mapped_hypergraph(path_.string() + "-missing"), std::system_error);
+
+   {
+      std::ofstream stream(path_, std::ios::binary);
+      stream << "not a hypergraph file at all, just some text";
+   }
+
+   ASSERT_THROW(mapped_hypergraph{path_}, std::runtime_error);
+
+   hypergraph<Block> graph;
+   auto nodes = graph.add_nodes(100);
+   graph.add_edge(nodes);
+   save_binary(graph, path_);
+   std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 300);
+
+   ASSERT_THROW(mapped_hypergraph{path_}, std::runtime_error);
+}
+} // namespace ctl::test
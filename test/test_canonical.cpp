@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include <ctl/canonical.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Vertex : public ctl::node<Vertex>
+{
+ public:
+   using ctl::node<Vertex>::node;
+};
+
+class CanonicalTestFixture : public ::testing::Test
+{
+ public:
+   CanonicalTestFixture() {}
+
+   ~CanonicalTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+// builds the hypergraph of relations over labels 0..node_count-1, with the labels permuted by
+// permutation and the edges inserted in the given order
+void build(hypergraph<Vertex>& hypergraph, size_t node_count,
+           const std::vector<std::vector<size_t>>& relations,
+           const std::vector<size_t>& permutation, const std::vector<size_t>& edge_order)
+{
+   auto nodes = hypergraph.add_nodes(node_count);
+
+   for (size_t edge : edge_order)
+   {
+      std::vector<cxptr<Vertex>> edge_nodes;
+
+      for (size_t label : relations[edge])
+      {
+         edge_nodes.push_back(nodes[permutation[label]]);
+      }
+
+      hypergraph.add_edge(edge_nodes);
+   }
+}
+
+TEST_F(CanonicalTestFixture, RelabelledHypergraphsHashEqually)
+{
+   const std::vector<std::vector<size_t>> relations = {
+      {0, 1, 2}, {2, 3}, {3, 0}, {1, 1}, {4, 2, 0}, {5}, {3, 4}};
+   const size_t node_count = 7;
+
+   std::mt19937_64 random(42);
+   std::vector<size_t> identity(node_count);
+   std::iota(identity.begin(), identity.end(), 0);
+   std::vector<size_t> edge_order(relations.size());
+   std::iota(edge_order.begin(), edge_order.end(), 0);
+
+   hypergraph<Vertex> reference;
+   build(reference, node_count, relations, identity, edge_order);
+
+   for (size_t trial = 0; trial < 20; ++trial)
+   {
+      std::vector<size_t> permutation = identity;
+      std::shuffle(permutation.begin(), permutation.end(), random);
+      std::shuffle(edge_order.begin(), edge_order.end(), random);
+
+      hypergraph<Vertex> relabelled;
+      build(relabelled, node_count, relations, permutation, edge_order);
+
+      ASSERT_EQ(hash_canonical(relabelled), hash_canonical(reference));
+      ASSERT_TRUE(is_isomorphic(relabelled, reference));
+   }
+
+   // reversing one edge changes the structure
+   std::vector<std::vector<size_t>> reversed = relations;
+   std::reverse(reversed[1].begin(), reversed[1].end());
+
+   hypergraph<Vertex> other;
+   build(other, node_count, reversed, identity, edge_order);
+   ASSERT_NE(hash_canonical(other), hash_canonical(reference));
+   ASSERT_FALSE(is_isomorphic(other, reference));
+}
+
+TEST_F(CanonicalTestFixture, SymmetricHypergraphs)
+{
+   // a directed cycle and many identical disjoint components
+   std::vector<std::vector<size_t>> cycle;
+   std::vector<std::vector<size_t>> components;
+
+   for (size_t i = 0; i < 12; ++i)
+   {
+      cycle.push_back({i, (i + 1) % 12});
+   }
+
+   for (size_t i = 0; i < 60; i += 3)
+   {
+      components.push_back({i, i + 1});
+      components.push_back({i + 1, i + 2});
+      components.push_back({i, i + 2});
+   }
+
+   for (auto [relations, node_count] : {std::pair{cycle, 12}, std::pair{components, 60}})
+   {
+      std::vector<size_t> identity(node_count);
+      std::iota(identity.begin(), identity.end(), 0);
+      std::vector<size_t> permutation(identity.rbegin(), identity.rend());
+      std::vector<size_t> edge_order(relations.size());
+      std::iota(edge_order.begin(), edge_order.end(), 0);
+
+      hypergraph<Vertex> lhs;
+      hypergraph<Vertex> rhs;
+      build(lhs, node_count, relations, identity, edge_order);
+      build(rhs, node_count, relations, permutation, edge_order);
+      ASSERT_TRUE(is_isomorphic(lhs, rhs));
+   }
+
+   // two triangles and one hexagon have the same refinement but are not isomorphic
+   hypergraph<Vertex> triangles;
+   hypergraph<Vertex> hexagon;
+   std::vector<size_t> identity(6);
+   std::iota(identity.begin(), identity.end(), 0);
+   build(triangles, 6, {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}}, identity,
+         {0, 1, 2, 3, 4, 5});
+   build(hexagon, 6, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 0}}, identity,
+         {0, 1, 2, 3, 4, 5});
+   ASSERT_FALSE(is_isomorphic(triangles, hexagon));
+}
+
+TEST_F(CanonicalTestFixture, CanonicalOrderMapsIsomorphicNodes)
+{
+   hypergraph<Vertex> lhs;
+   hypergraph<Vertex> rhs;
+   build(lhs, 4, {{0, 1}, {1, 2}, {1, 3}}, {0, 1, 2, 3}, {0, 1, 2});
+   build(rhs, 4, {{0, 1}, {1, 2}, {1, 3}}, {3, 2, 1, 0}, {2, 0, 1});
+
+   auto lhs_order = canonical_order(lhs);
+   auto rhs_order = canonical_order(rhs);
+   ASSERT_EQ(lhs_order.size(), 4);
+
+   // the hub and the source of the star end up at the same positions
+   for (size_t i = 0; i < lhs_order.size(); ++i)
+   {
+      ASSERT_EQ(lhs_order[i].lock()->get_incident_edges().size(),
+                rhs_order[i].lock()->get_incident_edges().size());
+   }
+}
+
+TEST_F(CanonicalTestFixture, RuleCanonicalization)
+{
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+   cnr::Rule relabelled({{{7, 5}, {7, 9}}, {{7, 9}, {7, 2}, {9, 2}, {5, 2}}});
+   cnr::Rule different({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {4, 3}}});
+
+   ASSERT_EQ(hash_canonical(rule), hash_canonical(relabelled));
+   ASSERT_NE(hash_canonical(rule), hash_canonical(different));
+
+   rule.Canonicalize();
+   relabelled.Canonicalize();
+   ASSERT_EQ(rule, relabelled);
+
+   // canonical rules use the labels 1..n and keep their meaning
+   ASSERT_EQ(rule.first.size(), 2);
+   ASSERT_EQ(rule.second.size(), 4);
+   ASSERT_EQ(hash_canonical(rule), hash_canonical(relabelled));
+
+   cnr::Rule copy = rule;
+   copy.Canonicalize();
+   ASSERT_EQ(copy, rule);
+}
+} // namespace ctl::test
@@ -0,0 +1,120 @@
+#include <ctl/hypergraph.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Bar : public ctl::node<Bar>
+{
+ public:
+   using ctl::node<Bar>::node;
+};
+
+class CompactViewTestFixture : public ::testing::Test
+{
+ public:
+   CompactViewTestFixture() {}
+
+   ~CompactViewTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+TEST_F(CompactViewTestFixture, FreezeEmptyHypergraph)
+{
+   hypergraph<Bar> hypergraph;
+
+   auto view = hypergraph.freeze();
+   ASSERT_EQ(view.node_count(), 0);
+   ASSERT_EQ(view.edge_count(), 0);
+}
+
+TEST_F(CompactViewTestFixture, FreezeMirrorsIncidence)
+{
+   hypergraph<Bar> hypergraph;
+
+   auto nodes = hypergraph.add_nodes(4);
+   auto edge1 = hypergraph.add_edge({nodes[0], nodes[1], nodes[2]});
+   auto edge2 = hypergraph.add_edge({nodes[2], nodes[3]});
+
+   auto view = hypergraph.freeze();
+   ASSERT_EQ(view.node_count(), 4);
+   ASSERT_EQ(view.edge_count(), 2);
+
+   auto n0 = view.index_of(nodes[0]).value();
+   auto n2 = view.index_of(nodes[2]).value();
+   auto n3 = view.index_of(nodes[3]).value();
+   auto e1 = view.index_of(edge1).value();
+   auto e2 = view.index_of(edge2).value();
+
+   auto incident_nodes = view.get_incident_nodes(e1);
+   ASSERT_EQ(incident_nodes.size(), 3);
+   ASSERT_EQ(view.get_node(incident_nodes[0]).get_shared_ptr(), nodes[0].get_shared_ptr());
+   ASSERT_EQ(view.get_node(incident_nodes[2]).get_shared_ptr(), nodes[2].get_shared_ptr());
+
+   ASSERT_EQ(view.get_incident_edges(n2).size(), 2);
+   ASSERT_EQ(view.get_incident_edges(n0).size(), 1);
+   ASSERT_EQ(view.get_edge(view.get_incident_edges(n3)[0]).get_shared_ptr(),
+             edge2.get_shared_ptr());
+
+   ASSERT_TRUE(view.is_incident_to(n2, e1));
+   ASSERT_TRUE(view.is_incident_to(n2, e2));
+   ASSERT_FALSE(view.is_incident_to(n0, e2));
+
+   ASSERT_EQ(view.get_adjacent_nodes(n2).size(), 3);
+   ASSERT_EQ(view.get_adjacent_edges(e1).size(), 1);
+   ASSERT_TRUE(view.is_adjacent_to(n0, n2));
+   ASSERT_FALSE(view.is_adjacent_to(n0, n3));
+}
+
+TEST_F(CompactViewTestFixture, FrozenViewIsUnaffectedByLaterChanges)
+{
+   hypergraph<Bar> hypergraph;
+
+   auto nodes = hypergraph.add_nodes(2);
+   auto edge  = hypergraph.add_edge({nodes[0], nodes[1]});
+
+   auto view = hypergraph.freeze();
+   hypergraph.remove_edge(edge);
+
+   ASSERT_EQ(view.edge_count(), 1);
+   ASSERT_EQ(view.get_incident_nodes(0).size(), 2);
+   ASSERT_FALSE(view.get_edge(0).is_valid());
+   ASSERT_FALSE(view.index_of(edge).has_value());
+}
+
+TEST_F(CompactViewTestFixture, OutOfRangeIndexThrows)
+{
+   hypergraph<Bar> hypergraph;
+   hypergraph.add_nodes(1);
+
+   auto view = hypergraph.freeze();
+   ASSERT_THROW(view.get_incident_edges(1), std::out_of_range);
+   ASSERT_THROW(view.get_incident_nodes(0), std::out_of_range);
+   ASSERT_FALSE(view.is_incident_to(0, 0));
+}
+
+TEST_F(CompactViewTestFixture, ForeignNodeThrows)
+{
+   hypergraph<Bar> other;
+   auto foreign = other.add_nodes(3);
+
+   // the foreign node's slot is vacant in this hypergraph
+   hypergraph<Bar> vacant;
+   auto nodes = vacant.add_nodes(3);
+   auto edge  = vacant.add_edge({nodes[0]});
+   vacant.remove_node(nodes[2]);
+   edge->add_node(foreign[2]);
+   ASSERT_THROW(vacant.freeze(), std::invalid_argument);
+
+   // the foreign node's handle addresses a different node of this hypergraph
+   hypergraph<Bar> occupied;
+   nodes = occupied.add_nodes(2);
+   edge  = occupied.add_edge({nodes[0]});
+   edge->add_node(foreign[1]);
+   ASSERT_EQ(nodes[1]->get_handle(), foreign[1]->get_handle());
+   ASSERT_THROW(occupied.freeze(), std::invalid_argument);
+}
+} // namespace ctl::test
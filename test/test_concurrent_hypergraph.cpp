@@ -0,0 +1,118 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <ctl/concurrent_hypergraph.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Site : public ctl::node<Site>
+{
+ public:
+   using ctl::node<Site>::node;
+};
+
+class ConcurrentHypergraphTestFixture : public ::testing::Test
+{
+ public:
+   ConcurrentHypergraphTestFixture() {}
+
+   ~ConcurrentHypergraphTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+TEST_F(ConcurrentHypergraphTestFixture, PinnedSnapshotsAreNotReclaimed)
+{
+   concurrent_hypergraph<Site> graph;
+   auto reader = graph.make_reader();
+
+   auto node = graph.edit().add_node();
+   graph.publish();
+   ASSERT_EQ(graph.collect(), 0);
+
+   {
+      auto view = reader.pin();
+      ASSERT_EQ(view->node_count(), 1);
+
+      graph.edit().add_edge({node, node});
+      graph.publish();
+      graph.publish();
+
+      // the pinned snapshot and the one published after it are kept alive
+      ASSERT_EQ(view->edge_count(), 0);
+      ASSERT_EQ(graph.retired_count(), 2);
+   }
+
+   ASSERT_EQ(graph.collect(), 0);
+   ASSERT_EQ(reader.pin()->edge_count(), 1);
+}
+
+TEST_F(ConcurrentHypergraphTestFixture, ReaderSlotsAreBounded)
+{
+   concurrent_hypergraph<Site> graph({}, 2);
+   auto first  = graph.make_reader();
+   auto second = graph.make_reader();
+   ASSERT_THROW(graph.make_reader(), std::length_error);
+
+   {
+      auto moved = std::move(first);
+   }
+
+   ASSERT_NO_THROW(graph.make_reader());
+}
+
+TEST_F(ConcurrentHypergraphTestFixture, ReadersSeeConsistentSnapshots)
+{
+   concurrent_hypergraph<Site> graph;
+   std::atomic<bool> done{false};
+   std::atomic<size_t> inconsistent{0};
+   std::vector<std::thread> readers;
+
+   graph.edit().add_node();
+   graph.publish();
+
+   for (size_t i = 0; i < 4; ++i)
+   {
+      readers.emplace_back([&]
+      {
+         auto reader = graph.make_reader();
+
+         while (!done.load())
+         {
+            // the writer keeps the graph a path, so every snapshot has one edge less than nodes
+            // and its last node is incident to exactly one edge
+            auto view  = reader.pin();
+            auto nodes = view->get_nodes();
+
+            if (view->edge_count() + 1 != view->node_count() ||
+                (nodes.size() > 1 && view->get_incident_edges(nodes.back()).size() != 1))
+            {
+               ++inconsistent;
+            }
+         }
+      });
+   }
+
+   for (uint32_t node = 0; node < 2000; ++node)
+   {
+      const uint32_t added = graph.edit().add_node();
+      graph.edit().add_edge({node, added});
+      graph.publish();
+   }
+
+   done.store(true);
+
+   for (std::thread& reader : readers)
+   {
+      reader.join();
+   }
+
+   ASSERT_EQ(inconsistent.load(), 0);
+   ASSERT_EQ(graph.collect(), 0);
+}
+} // namespace ctl::test
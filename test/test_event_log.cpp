@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include <ctl/rewriter.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Token : public ctl::node<Token>
+{
+ public:
+   using ctl::node<Token>::node;
+};
+
+class EventLogTestFixture : public ::testing::Test
+{
+ public:
+   EventLogTestFixture() {}
+
+   ~EventLogTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+TEST_F(EventLogTestFixture, LogIsOptIn)
+{
+   hypergraph<Token> hypergraph;
+   auto nodes = hypergraph.add_nodes(2);
+   hypergraph.add_edge({nodes[0], nodes[1]});
+
+   rewriter<Token> rewriter(hypergraph, cnr::Rule({{{1, 2}}, {{1, 3}, {3, 2}}}));
+   rewriter.run(2);
+   ASSERT_EQ(rewriter.get_event_log(), nullptr);
+}
+
+TEST_F(EventLogTestFixture, RecordsConsumedAndProducedEdges)
+{
+   hypergraph<Token> hypergraph;
+   auto nodes = hypergraph.add_nodes(2);
+   auto first = hypergraph.add_edge({nodes[0], nodes[1]}).lock()->get_id();
+
+   rewriter<Token> rewriter(hypergraph, cnr::Rule({{{1, 2}}, {{1, 3}, {3, 2}}}));
+   rewriter.enable_event_log();
+   ASSERT_EQ(rewriter.run(3), 3);
+
+   const auto& log = *rewriter.get_event_log();
+   ASSERT_EQ(log.event_count(), 3);
+   ASSERT_EQ(log.get_consumed(0).size(), 1);
+   ASSERT_EQ(log.get_consumed(0)[0], first);
+   ASSERT_EQ(log.get_produced(0).size(), 2);
+
+   // every later event consumes an edge some earlier event produced
+   auto causal = log.build_causal_graph();
+   ASSERT_EQ(causal.event_count(), 3);
+   ASSERT_EQ(causal.edge_count(), 2);
+   ASSERT_TRUE(causal.get_causes(0).empty());
+
+   for (size_t event = 1; event < 3; ++event)
+   {
+      ASSERT_EQ(causal.get_causes(event).size(), 1);
+      auto cause   = causal.get_causes(event)[0];
+      auto effects = causal.get_effects(cause);
+      ASSERT_NE(std::find(effects.begin(), effects.end(), event), effects.end());
+   }
+
+   ASSERT_THROW(causal.get_effects(3), std::out_of_range);
+}
+
+TEST_F(EventLogTestFixture, GenerationsAreLogged)
+{
+   hypergraph<Token> hypergraph;
+   auto nodes = hypergraph.add_nodes(2);
+   hypergraph.add_edge({nodes[0], nodes[1]});
+
+   rewriter<Token> rewriter(hypergraph, cnr::Rule({{{1, 2}}, {{1, 3}, {3, 2}}}));
+   rewriter.enable_event_log();
+   rewriter.set_thread_count(2);
+   ASSERT_EQ(rewriter.run_generations(3), 7);
+
+   // each event of a generation consumes an edge produced by one event of the previous one
+   auto causal = rewriter.get_event_log()->build_causal_graph();
+   ASSERT_EQ(causal.event_count(), 7);
+   ASSERT_EQ(causal.edge_count(), 6);
+   ASSERT_EQ(causal.get_effects(0).size(), 2);
+
+   for (size_t event = 1; event < 3; ++event)
+   {
+      ASSERT_EQ(causal.get_causes(event).size(), 1);
+      ASSERT_EQ(causal.get_causes(event)[0], 0);
+      ASSERT_EQ(causal.get_effects(event).size(), 2);
+   }
+}
+} // namespace ctl::test
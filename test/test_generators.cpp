@@ -0,0 +1,186 @@
+#include <algorithm>
+
+#include <ctl/compact_view.hpp>
+#include <ctl/generators.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Grain : public ctl::node<Grain>
+{
+ public:
+   using ctl::node<Grain>::node;
+};
+
+class GeneratorsTestFixture : public ::testing::Test
+{
+ public:
+   GeneratorsTestFixture() {}
+
+   ~GeneratorsTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+// the node numbers of every edge in get_edges order
+std::vector<std::vector<uint32_t>> edge_lists(const hypergraph<Grain>& graph)
+{
+   const compact_view<Grain> view = graph.freeze();
+   std::vector<std::vector<uint32_t>> edges;
+
+   for (uint32_t edge = 0; edge < view.edge_count(); ++edge)
+   {
+      auto nodes = view.get_incident_nodes(edge);
+      edges.emplace_back(nodes.begin(), nodes.end());
+   }
+
+   return edges;
+}
+
+bool has_distinct_nodes(const std::vector<uint32_t>& edge)
+{
+   std::vector<uint32_t> sorted = edge;
+   std::ranges::sort(sorted);
+   return std::ranges::adjacent_find(sorted) == sorted.end();
+}
+
+TEST_F(GeneratorsTestFixture, UniformIsReproducible)
+{
+   hypergraph<Grain> single;
+   auto built = generate_uniform(single, 100, 10000, 3, {.seed = 7});
+   ASSERT_EQ(built.nodes.size(), 100);
+   ASSERT_EQ(built.edges.size(), 10000);
+
+   const auto edges = edge_lists(single);
+
+   for (const auto& edge : edges)
+   {
+      ASSERT_EQ(edge.size(), 3);
+      ASSERT_TRUE(has_distinct_nodes(edge));
+   }
+
+   // the blocks of edges come out the same on any number of threads
+   hypergraph<Grain> parallel;
+   generate_uniform(parallel, 100, 10000, 3, {.seed = 7, .thread_count = 4});
+   ASSERT_EQ(edge_lists(parallel), edges);
+
+   hypergraph<Grain> reseeded;
+   generate_uniform(reseeded, 100, 10000, 3, {.seed = 8});
+   ASSERT_NE(edge_lists(reseeded), edges);
+
+   hypergraph<Grain> invalid;
+   ASSERT_THROW(generate_uniform(invalid, 2, 1, 3), std::invalid_argument);
+}
+
+TEST_F(GeneratorsTestFixture, ChungLuSkewsDegrees)
+{
+   hypergraph<Grain> graph;
+   generate_chung_lu(graph, 1000, 5000, 2, 2.5, {.seed = 3, .thread_count = 2});
+
+   const compact_view<Grain> view = graph.freeze();
+   ASSERT_EQ(view.edge_count(), 5000);
+   ASSERT_GT(view.get_incident_edges(0).size(), 10 * view.get_incident_edges(999).size() + 10);
+
+   for (const auto& edge : edge_lists(graph))
+   {
+      ASSERT_TRUE(has_distinct_nodes(edge));
+   }
+
+   hypergraph<Grain> again;
+   generate_chung_lu(again, 1000, 5000, 2, 2.5, {.seed = 3});
+   ASSERT_EQ(edge_lists(again), edge_lists(graph));
+
+   ASSERT_THROW(generate_chung_lu(again, 10, 1, 2, 1.0), std::invalid_argument);
+}
+
+TEST_F(GeneratorsTestFixture, ChungLuWithExponentNearOne)
+{
+   // node 0 carries nearly all of the weight and the others next to none
+   hypergraph<Grain> graph;
+   generate_chung_lu(graph, 1000, 10, 2, 1.01, {.seed = 5});
+
+   for (const auto& edge : edge_lists(graph))
+   {
+      ASSERT_TRUE(has_distinct_nodes(edge));
+      ASSERT_EQ(std::ranges::count(edge, 0u), 1);
+   }
+
+   hypergraph<Grain> whole;
+   generate_chung_lu(whole, 4, 10, 4, 1.01, {.seed = 5});
+   ASSERT_EQ(whole.get_edges().size(), 10);
+
+   for (const auto& edge : edge_lists(whole))
+   {
+      ASSERT_TRUE(has_distinct_nodes(edge));
+   }
+}
+
+TEST_F(GeneratorsTestFixture, PlantedPartitionKeepsEdgesInCommunities)
+{
+   hypergraph<Grain> graph;
+   generate_planted_partition(graph, 90, 2000, 4, 3, 1.0, {.seed = 11});
+
+   for (const auto& edge : edge_lists(graph))
+   {
+      ASSERT_TRUE(has_distinct_nodes(edge));
+
+      for (uint32_t node : edge)
+      {
+         ASSERT_EQ(node / 30, edge.front() / 30);
+      }
+   }
+
+   hypergraph<Grain> mixed;
+   generate_planted_partition(mixed, 90, 2000, 4, 3, 0.5, {.seed = 11});
+   size_t crossing = 0;
+
+   for (const auto& edge : edge_lists(mixed))
+   {
+      crossing += std::ranges::any_of(edge, [&edge](uint32_t node)
+      { return node / 30 != edge.front() / 30; });
+   }
+
+   ASSERT_GT(crossing, 500);
+   ASSERT_LT(crossing, 1000);
+
+   ASSERT_THROW(generate_planted_partition(mixed, 9, 1, 4, 3, 1.0), std::invalid_argument);
+   ASSERT_THROW(generate_planted_partition(mixed, 9, 1, 2, 0, 1.0), std::invalid_argument);
+   ASSERT_THROW(generate_planted_partition(mixed, 9, 1, 2, 3, 1.5), std::invalid_argument);
+}
+
+TEST_F(GeneratorsTestFixture, Lattice)
+{
+   const size_t line_extents[] = {4};
+   hypergraph<Grain> line;
+   generate_lattice(line, line_extents);
+   ASSERT_EQ(edge_lists(line), (std::vector<std::vector<uint32_t>>{{0, 1}, {1, 2}, {2, 3}}));
+
+   const size_t grid_extents[] = {3, 4};
+   hypergraph<Grain> grid;
+   auto built = generate_lattice(grid, grid_extents);
+   ASSERT_EQ(built.nodes.size(), 12);
+   ASSERT_EQ(edge_lists(grid).size(), 6);
+   ASSERT_EQ(edge_lists(grid)[0], (std::vector<uint32_t>{0, 1, 4, 5}));
+   ASSERT_EQ(edge_lists(grid)[5], (std::vector<uint32_t>{6, 7, 10, 11}));
+
+   hypergraph<Grain> torus;
+   generate_lattice(torus, grid_extents, true, 3);
+   const auto cells = edge_lists(torus);
+   ASSERT_EQ(cells.size(), 12);
+   ASSERT_EQ(cells.back(), (std::vector<uint32_t>{11, 8, 3, 0}));
+
+   const compact_view<Grain> view = torus.freeze();
+
+   for (uint32_t node = 0; node < view.node_count(); ++node)
+   {
+      ASSERT_EQ(view.get_incident_edges(node).size(), 4);
+   }
+
+   const size_t flat_extents[] = {2, 3};
+   ASSERT_THROW(generate_lattice(torus, flat_extents, true), std::invalid_argument);
+   ASSERT_THROW(generate_lattice(torus, std::span<const size_t>()), std::invalid_argument);
+}
+} // namespace ctl::test
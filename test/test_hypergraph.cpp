@@ -1,6 +1,9 @@
 #include <ctl/hypergraph.hpp>
 #include <gtest/gtest.h>
 
+#include <ranges>
+#include <unordered_set>
+
 namespace ctl::test
 {
 class Foo : public ctl::node<Foo>
@@ -12,6 +15,12 @@ class Foo : public ctl::node<Foo>
    const char* name_ = "";
 };
 
+class Baz : public ctl::node<Baz, ctl::uuid_identity>
+{
+ public:
+   using ctl::node<Baz, ctl::uuid_identity>::node;
+};
+
 class HypergraphTestFixture : public ::testing::Test
 {
  public:
@@ -291,4 +300,401 @@ TEST_F(HypergraphTestFixture, AddNodesToEdgeAtSpecificPoint)
    ASSERT_TRUE(node4->is_incident_to(edge));
    ASSERT_EQ(hypergraph.get_nodes().size(), 4);
 }
+
+TEST_F(HypergraphTestFixture, DestroyingHypergraphReleasesNodesAndEdges)
+{
+   cxptr<Foo> node;
+   cxptr<hyperedge<Foo>> edge;
+
+   {
+      hypergraph<Foo> hypergraph;
+      auto nodes = hypergraph.add_nodes(3);
+      edge       = hypergraph.add_edge({nodes[0], nodes[1], nodes[2]});
+      node       = nodes[0];
+   }
+
+   ASSERT_FALSE(node.is_valid());
+   ASSERT_FALSE(edge.is_valid());
+}
+
+TEST_F(HypergraphTestFixture, PooledStorageMode)
+{
+   cxptr<Foo> node;
+
+   {
+      hypergraph<Foo> hypergraph(storage_mode::pooled);
+      ASSERT_EQ(hypergraph.get_storage_mode(), storage_mode::pooled);
+
+      node       = hypergraph.add_node(1, "foo");
+      auto nodes = hypergraph.add_nodes(1000);
+      auto edge  = hypergraph.add_edge({node, nodes[0], nodes[999]});
+
+      ASSERT_EQ(node->value_, 1);
+      ASSERT_STREQ(node->name_, "foo");
+      ASSERT_EQ(edge->get_incident_nodes().size(), 3);
+      ASSERT_EQ(hypergraph.get_nodes().size(), 1001);
+
+      hypergraph.remove_edge(edge);
+      ASSERT_FALSE(edge.is_valid());
+
+      auto recycled_edge = hypergraph.add_edge({nodes[1], nodes[2]});
+      ASSERT_TRUE(recycled_edge.is_valid());
+      ASSERT_EQ(nodes[1]->get_incident_edges().size(), 1);
+   }
+
+   // the control block lives in the pool and must stay readable after the hypergraph is gone
+   ASSERT_FALSE(node.is_valid());
+}
+
+TEST_F(HypergraphTestFixture, ResolveHandles)
+{
+   hypergraph<Foo> hypergraph;
+
+   auto node1 = hypergraph.add_node(1, "foo");
+   auto node2 = hypergraph.add_node(2, "bar");
+   auto edge  = hypergraph.add_edge({node1, node2});
+
+   auto node_handle = node1->get_handle();
+   auto edge_handle = edge->get_handle();
+
+   ASSERT_TRUE(hypergraph.contains(node_handle));
+   ASSERT_TRUE(hypergraph.contains(edge_handle));
+   ASSERT_EQ(hypergraph.get_node(node_handle).get_shared_ptr(), node1.get_shared_ptr());
+   ASSERT_EQ(hypergraph.get_edge(edge_handle).get_shared_ptr(), edge.get_shared_ptr());
+   ASSERT_FALSE(hypergraph.contains(handle<Foo>()));
+}
+
+TEST_F(HypergraphTestFixture, RemoveByHandleInvalidatesHandle)
+{
+   hypergraph<Foo> hypergraph;
+
+   auto nodes = hypergraph.add_nodes(3);
+   auto edge1 = hypergraph.add_edge({nodes[0], nodes[1]});
+   auto edge2 = hypergraph.add_edge({nodes[1], nodes[2]});
+
+   auto stale_handle = edge1->get_handle();
+   hypergraph.remove_edge(stale_handle);
+
+   ASSERT_FALSE(edge1.is_valid());
+   ASSERT_FALSE(hypergraph.contains(stale_handle));
+   ASSERT_EQ(nodes[0]->get_incident_edges().size(), 0);
+   ASSERT_EQ(nodes[1]->get_incident_edges().size(), 1);
+
+   // the freed slot is reused, but the old handle must not resolve to the new edge
+   auto edge3 = hypergraph.add_edge({nodes[0], nodes[2]});
+   ASSERT_EQ(edge3->get_handle().index, stale_handle.index);
+   ASSERT_FALSE(hypergraph.get_edge(stale_handle).is_valid());
+   ASSERT_TRUE(hypergraph.get_edge(edge3->get_handle()).is_valid());
+
+   hypergraph.remove_node(nodes[1]->get_handle());
+   ASSERT_FALSE(nodes[1].is_valid());
+   ASSERT_EQ(edge2->get_incident_nodes().size(), 1);
+   ASSERT_EQ(hypergraph.get_nodes().size(), 2);
+   ASSERT_EQ(hypergraph.get_edges().size(), 2);
+}
+
+TEST_F(HypergraphTestFixture, RemoveNodeWithEdges)
+{
+   hypergraph<Foo> hypergraph;
+
+   auto nodes = hypergraph.add_nodes(3);
+   auto edge  = hypergraph.add_edge({nodes[0], nodes[1], nodes[0]});
+   hypergraph.remove_node(nodes[0]);
+
+   ASSERT_FALSE(nodes[0].is_valid());
+   ASSERT_EQ(edge->get_incident_nodes().size(), 1);
+   ASSERT_EQ(edge->get_incident_nodes()[0].get_shared_ptr(), nodes[1].get_shared_ptr());
+   ASSERT_EQ(nodes[1]->get_incident_edges().size(), 1);
+}
+
+TEST_F(HypergraphTestFixture, MonotonicIdentityIsPerHypergraph)
+{
+   hypergraph<Foo> hypergraph1;
+   hypergraph<Foo> hypergraph2;
+
+   auto nodes = hypergraph1.add_nodes(3);
+   auto edge  = hypergraph1.add_edge({nodes[0], nodes[1]});
+   auto other = hypergraph2.add_node();
+
+   ASSERT_EQ(nodes[0]->get_id(), 1);
+   ASSERT_EQ(nodes[1]->get_id(), 2);
+   ASSERT_EQ(nodes[2]->get_id(), 3);
+   ASSERT_EQ(edge->get_id(), 4);
+   ASSERT_EQ(other->get_id(), 1);
+   ASSERT_NE(hypergraph1.get_id(), hypergraph2.get_id());
+   ASSERT_TRUE(nodes[0].get() == nodes[0].get());
+   ASSERT_TRUE(nodes[0].get() != nodes[1].get());
+
+   std::unordered_set<Foo::identity_policy::id_type> ids;
+
+   for (auto& node : hypergraph1.get_nodes())
+   {
+      ids.insert(node->get_id());
+   }
+
+   ASSERT_EQ(ids.size(), 3);
+}
+
+TEST_F(HypergraphTestFixture, UuidIdentity)
+{
+   hypergraph<Baz> hypergraph;
+
+   auto nodes = hypergraph.add_nodes(100);
+   auto edge  = hypergraph.add_edge({nodes[0], nodes[1]});
+
+   std::unordered_set<internal::uuid> ids;
+
+   for (auto& node : nodes)
+   {
+      ids.insert(node->get_id());
+   }
+
+   ids.insert(edge->get_id());
+   ASSERT_EQ(ids.size(), 101);
+   ASSERT_FALSE(ids.contains(internal::uuid()));
+}
+
+TEST_F(HypergraphTestFixture, LazyIncidenceViews)
+{
+   hypergraph<Foo> hypergraph;
+
+   auto node1 = hypergraph.add_node(1, "foo");
+   auto node2 = hypergraph.add_node(2, "bar");
+   auto node3 = hypergraph.add_node(3, "baz");
+   auto edge1 = hypergraph.add_edge({node1, node2});
+   auto edge2 = hypergraph.add_edge({node1, node2, node3});
+
+   ASSERT_EQ(std::ranges::distance(hypergraph.nodes()), 3);
+   ASSERT_EQ(std::ranges::distance(hypergraph.edges()), 2);
+   ASSERT_EQ(std::ranges::distance(node1->incident_edges()), 2);
+   ASSERT_EQ(std::ranges::distance(edge2->incident_nodes()), 3);
+
+   // node2 is reached once through each shared edge, matching get_adjacent_nodes
+   ASSERT_EQ(std::ranges::distance(node1->adjacent_nodes()), 3);
+   ASSERT_EQ(std::ranges::distance(node1->adjacent_nodes()),
+             static_cast<std::ptrdiff_t>(node1->get_adjacent_nodes().size()));
+   ASSERT_EQ(std::ranges::distance(edge1->adjacent_edges()), 2);
+
+   size_t sum = 0;
+
+   for (const Foo& node : node1->adjacent_nodes())
+   {
+      sum += node.value_;
+   }
+
+   ASSERT_EQ(sum, 2 + 2 + 3);
+
+   auto large_values = node1->adjacent_nodes()
+                     | std::views::filter([](const Foo& node) { return node.value_ > 2; })
+                     | std::views::transform([](const Foo& node) { return node.name_; });
+
+   ASSERT_EQ(std::ranges::distance(large_values), 1);
+   ASSERT_STREQ(*large_values.begin(), "baz");
+
+   for (const hyperedge<Foo>& edge : node3->incident_edges())
+   {
+      ASSERT_EQ(&edge, edge2.get_shared_ptr().get());
+   }
+}
+
+TEST_F(HypergraphTestFixture, UniqueAdjacency)
+{
+   hypergraph<Foo> hypergraph;
+
+   auto hub   = hypergraph.add_node(0, "hub");
+   auto nodes = hypergraph.add_nodes(3);
+   auto edge1 = hypergraph.add_edge({hub, nodes[0], nodes[1]});
+   auto edge2 = hypergraph.add_edge({hub, nodes[0], hub});
+   auto edge3 = hypergraph.add_edge({nodes[1], nodes[2]});
+
+   ASSERT_EQ(hub->get_adjacent_nodes().size(), 4);
+   ASSERT_EQ(hub->get_unique_adjacent_nodes().size(), 2);
+   ASSERT_EQ(hub->count_adjacent_nodes(), 2);
+   ASSERT_EQ(nodes[1]->count_adjacent_nodes(), 3);
+   ASSERT_EQ(nodes[2]->count_adjacent_nodes(), 1);
+
+   for (auto& node : hub->get_unique_adjacent_nodes())
+   {
+      ASSERT_NE(node.get_shared_ptr(), hub.get_shared_ptr());
+   }
+
+   ASSERT_EQ(edge1->get_unique_adjacent_edges().size(), 2);
+   ASSERT_EQ(edge1->count_adjacent_edges(), 2);
+   ASSERT_EQ(edge2->count_adjacent_edges(), 1);
+   ASSERT_EQ(edge3->count_adjacent_edges(), 1);
+
+   // repeated queries start from a fresh epoch
+   ASSERT_EQ(hub->count_adjacent_nodes(), 2);
+}
+
+TEST_F(HypergraphTestFixture, CopyIsDeep)
+{
+   hypergraph<Foo> original(storage_mode::pooled);
+
+   auto nodes = original.add_nodes(3);
+   auto edge  = original.add_edge({nodes[0], nodes[1], nodes[0]});
+   original.add_edge({nodes[1], nodes[2]});
+
+   hypergraph<Foo> copy = original;
+   ASSERT_NE(copy.get_id(), original.get_id());
+   ASSERT_EQ(copy.get_nodes().size(), 3);
+   ASSERT_EQ(copy.get_edges().size(), 2);
+
+   // the copy has its own elements under the same handles and ids
+   auto copied_edge = copy.get_edge(edge->get_handle());
+   ASSERT_NE(copied_edge.get_shared_ptr(), edge.get_shared_ptr());
+   ASSERT_EQ(copied_edge->get_id(), edge->get_id());
+   ASSERT_EQ(copied_edge->get_incident_nodes().size(), 3);
+
+   for (auto& node : copied_edge->get_incident_nodes())
+   {
+      ASSERT_EQ(copy.get_node(node->get_handle()).get_shared_ptr(), node.get_shared_ptr());
+   }
+
+   auto copied_node = copy.get_node(nodes[0]->get_handle());
+   ASSERT_EQ(copied_node->get_incident_edges().size(), 2);
+   ASSERT_EQ(copied_node->get_incident_edges()[0].get_shared_ptr(), copied_edge.get_shared_ptr());
+
+   // changes do not leak between the two
+   copy.remove_edge(copied_edge);
+   ASSERT_EQ(original.get_edges().size(), 2);
+   ASSERT_EQ(nodes[0]->get_incident_edges().size(), 2);
+
+   original = copy;
+   ASSERT_EQ(original.get_edges().size(), 1);
+   ASSERT_TRUE(edge.expired());
+
+   // ids continue where the original left off
+   ASSERT_EQ(copy.add_node()->get_id(), original.add_node()->get_id());
+}
+
+TEST_F(HypergraphTestFixture, BulkRemoval)
+{
+   hypergraph<Foo> hypergraph;
+
+   auto nodes = hypergraph.add_nodes(6);
+   auto edges = hypergraph.add_edges({{nodes[0], nodes[1], nodes[0], nodes[2]},
+                                      {nodes[1], nodes[3]},
+                                      {nodes[4], nodes[1], nodes[5]},
+                                      {nodes[3], nodes[3]}});
+
+   // duplicates and stale pointers in the batch are ignored
+   hypergraph.remove_nodes({nodes[0], nodes[3], nodes[0], cxptr<Foo>()}, empty_edges::remove);
+
+   ASSERT_EQ(hypergraph.get_nodes().size(), 4);
+   ASSERT_EQ(hypergraph.get_edges().size(), 3);
+   ASSERT_TRUE(edges[3].expired());
+   ASSERT_EQ(edges[0]->get_incident_nodes().size(), 2);
+   ASSERT_EQ(edges[0]->get_incident_nodes()[0].get_shared_ptr(), nodes[1].get_shared_ptr());
+   ASSERT_EQ(edges[1]->get_incident_nodes().size(), 1);
+   ASSERT_EQ(nodes[1]->get_incident_edges().size(), 3);
+
+   // with empty edges kept the emptied edge stays in the graph
+   hypergraph.remove_nodes({nodes[1]});
+   ASSERT_EQ(hypergraph.get_edges().size(), 3);
+   ASSERT_TRUE(edges[1]->get_incident_nodes().empty());
+
+   hypergraph.remove_edges({edges[0], edges[2], edges[0]});
+   ASSERT_EQ(hypergraph.get_edges().size(), 1);
+   ASSERT_TRUE(edges[0].expired());
+   ASSERT_TRUE(nodes[2]->get_incident_edges().empty());
+   ASSERT_TRUE(nodes[4]->get_incident_edges().empty());
+   ASSERT_TRUE(nodes[5]->get_incident_edges().empty());
+}
+
+TEST_F(HypergraphTestFixture, MemoryFootprint)
+{
+   hypergraph<Foo> hypergraph(storage_mode::pooled);
+   const size_t pin_bytes = sizeof(std::shared_ptr<Foo>);
+
+   auto nodes = hypergraph.add_nodes(4);
+   auto edges = hypergraph.add_edges({{nodes[0], nodes[1], nodes[2]},
+                                      {nodes[0], nodes[3]},
+                                      {nodes[0], nodes[1]},
+                                      {nodes[0], nodes[2]}});
+
+   memory_footprint footprint = hypergraph.get_memory_footprint();
+   ASSERT_EQ(footprint.node_bytes, 4 * sizeof(Foo));
+   ASSERT_EQ(footprint.edge_bytes, 4 * sizeof(hyperedge<Foo>));
+   ASSERT_GT(footprint.control_block_bytes, 0);
+   ASSERT_EQ(footprint.incidence_bytes, 2 * 9 * pin_bytes);
+   ASSERT_GT(footprint.index_bytes, 0);
+   ASSERT_GT(footprint.pool_reserved_bytes, 0);
+
+   // removing edges leaves spare capacity in the incidence lists of their nodes
+   hypergraph.remove_edges({edges[2], edges[3]});
+   footprint = hypergraph.get_memory_footprint();
+   ASSERT_EQ(footprint.incidence_bytes, 2 * 5 * pin_bytes);
+   ASSERT_GT(footprint.incidence_slack_bytes, 0);
+
+   hypergraph.shrink_to_fit();
+   const memory_footprint shrunk = hypergraph.get_memory_footprint();
+   ASSERT_EQ(shrunk.incidence_bytes, footprint.incidence_bytes);
+   ASSERT_EQ(shrunk.incidence_slack_bytes, 0);
+   ASSERT_LT(shrunk.total(), footprint.total());
+
+   // handles survive the compaction
+   ASSERT_TRUE(hypergraph.contains(edges[0]->get_handle()));
+   ASSERT_EQ(nodes[0]->get_incident_edges().size(), 2);
+
+   ASSERT_EQ(ctl::hypergraph<Foo>().get_memory_footprint().pool_reserved_bytes, 0);
+}
+
+TEST_F(HypergraphTestFixture, MovedFromPooledHypergraph)
+{
+   hypergraph<Foo> source(storage_mode::pooled);
+   source.add_nodes(3);
+
+   hypergraph<Foo> constructed(std::move(source));
+   ASSERT_EQ(constructed.get_storage_mode(), storage_mode::pooled);
+   ASSERT_GT(constructed.get_memory_footprint().pool_reserved_bytes, 0);
+   ASSERT_EQ(source.get_storage_mode(), storage_mode::heap);
+   ASSERT_EQ(source.get_memory_footprint().pool_reserved_bytes, 0);
+
+   hypergraph<Foo> assigned;
+   assigned = std::move(constructed);
+   ASSERT_EQ(assigned.get_nodes().size(), 3);
+   ASSERT_EQ(constructed.get_storage_mode(), storage_mode::heap);
+   ASSERT_EQ(constructed.get_memory_footprint().pool_reserved_bytes, 0);
+
+   // the moved-from hypergraphs can still be used
+   constructed.add_node();
+   source.add_node();
+   ASSERT_EQ(constructed.get_nodes().size(), 1);
+   ASSERT_EQ(source.get_nodes().size(), 1);
+}
+
+TEST_F(HypergraphTestFixture, PinnedAccess)
+{
+   // only the single-threaded mode caches a pointer in every cxptr
+   static_assert(sizeof(cxptr<Foo>) ==
+                 sizeof(std::weak_ptr<Foo>) + (internal::single_threaded ? sizeof(Foo*) : 0));
+
+   hypergraph<Foo> hypergraph;
+   cxptr<Foo> node = hypergraph.add_node(7, "pinned");
+
+   {
+      pinned<Foo> foo = node.pin();
+      foo->value_ += 1;
+      ASSERT_EQ((*foo).value_, 8);
+      ASSERT_STREQ(foo.get().name_, "pinned");
+
+      // a pinned node outlives its removal until the end of the scope
+      hypergraph.remove_node(node);
+      ASSERT_TRUE(node.is_valid());
+      ASSERT_EQ(node->value_, 8);
+   }
+
+   ASSERT_FALSE(node.is_valid());
+   ASSERT_THROW(node.pin(), std::runtime_error);
+   ASSERT_THROW(node.get(), std::runtime_error);
+
+   cxptr<Foo> other = hypergraph.add_node(9, "other");
+   node.swap(other);
+   ASSERT_EQ(node->value_, 9);
+   ASSERT_THROW(other.get(), std::runtime_error);
+
+   node.reset();
+   ASSERT_THROW(node->value_, std::runtime_error);
+}
 } // namespace ctl::test
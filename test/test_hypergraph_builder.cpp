@@ -0,0 +1,231 @@
+#include <random>
+#include <thread>
+
+#include <ctl/hypergraph_builder.hpp>
+#include <ctl/match_index.hpp>
+#include <ctl/transaction.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Pin : public ctl::node<Pin>
+{
+ public:
+   using ctl::node<Pin>::node;
+   explicit Pin(int value) : value_(value) {}
+   int value_ = 0;
+};
+
+class HypergraphBuilderTestFixture : public ::testing::Test
+{
+ public:
+   HypergraphBuilderTestFixture() {}
+
+   ~HypergraphBuilderTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+// the ids of every incidence list, nodes first
+std::vector<std::vector<uint64_t>> incidence_ids(const hypergraph<Pin>& graph)
+{
+   std::vector<std::vector<uint64_t>> ids;
+
+   for (const Pin& node : graph.nodes())
+   {
+      std::vector<uint64_t>& list = ids.emplace_back(1, node.get_id());
+
+      for (const hyperedge<Pin>& edge : node.incident_edges())
+      {
+         list.push_back(edge.get_id());
+      }
+   }
+
+   for (const hyperedge<Pin>& edge : graph.edges())
+   {
+      std::vector<uint64_t>& list = ids.emplace_back(1, edge.get_id());
+
+      for (const Pin& node : edge.incident_nodes())
+      {
+         list.push_back(node.get_id());
+      }
+   }
+
+   return ids;
+}
+
+TEST_F(HypergraphBuilderTestFixture, BuildMatchesIncrementalConstruction)
+{
+   std::mt19937 random(7);
+   std::uniform_int_distribution<uint32_t> pick_node(0, 199);
+   std::uniform_int_distribution<size_t> pick_arity(1, 5);
+
+   std::vector<size_t> offsets{0};
+   std::vector<uint32_t> pins;
+
+   for (size_t edge = 0; edge < 1000; ++edge)
+   {
+      for (size_t pin = pick_arity(random); pin > 0; --pin)
+      {
+         pins.push_back(pick_node(random));
+      }
+
+      offsets.push_back(pins.size());
+   }
+
+   hypergraph<Pin> incremental;
+   incremental.add_node();
+   std::vector<cxptr<Pin>> nodes;
+
+   for (int value = 0; value < 200; ++value)
+   {
+      nodes.push_back(incremental.add_node(value));
+   }
+
+   for (size_t edge = 0; edge + 1 < offsets.size(); ++edge)
+   {
+      std::vector<cxptr<Pin>> edge_nodes;
+
+      for (size_t pin = offsets[edge]; pin < offsets[edge + 1]; ++pin)
+      {
+         edge_nodes.push_back(nodes[pins[pin]]);
+      }
+
+      incremental.add_edge(edge_nodes);
+   }
+
+   for (size_t thread_count : {1, 4})
+   {
+      hypergraph<Pin> built(storage_mode::pooled);
+      built.add_node();
+
+      hypergraph_builder<Pin> builder;
+      builder.reserve(200, 1000, pins.size());
+
+      for (int value = 0; value < 200; ++value)
+      {
+         ASSERT_EQ(builder.add_node(value), value);
+      }
+
+      builder.add_edges(offsets, pins);
+      ASSERT_EQ(builder.edge_count(), 1000);
+
+      auto handles = builder.build(built, thread_count);
+      ASSERT_EQ(builder.node_count(), 0);
+      ASSERT_EQ(handles.nodes.size(), 200);
+      ASSERT_EQ(handles.edges.size(), 1000);
+      ASSERT_EQ(built.get_node(handles.nodes[42])->value_, 42);
+      ASSERT_EQ(incidence_ids(built), incidence_ids(incremental));
+   }
+}
+
+TEST_F(HypergraphBuilderTestFixture, EdgeInputs)
+{
+   hypergraph_builder<Pin> builder;
+   builder.add_nodes(4);
+
+   builder.add_edge({0, 1});
+   builder.add_edges(std::vector<std::vector<int>>{{2, 3, 2}, {}, {3}});
+
+   const std::vector<size_t> offsets{1, 3, 4};
+   const std::vector<uint32_t> pins{9, 0, 3, 1};
+   builder.add_edges(offsets, pins);
+
+   ASSERT_THROW(builder.add_edge({0, 4}), std::out_of_range);
+   ASSERT_THROW(builder.add_edges(std::vector<std::vector<int>>{{1}, {0, -1}}),
+                std::out_of_range);
+   ASSERT_THROW(builder.add_edges(std::vector<size_t>{0, 2, 1}, pins), std::invalid_argument);
+   ASSERT_THROW(builder.add_edges(std::vector<size_t>{0, 5}, pins), std::invalid_argument);
+   ASSERT_EQ(builder.edge_count(), 6);
+   ASSERT_EQ(builder.pin_count(), 9);
+
+   hypergraph<Pin> graph;
+   auto built = builder.build(graph);
+   auto node  = graph.get_node(built.nodes[3]);
+
+   ASSERT_EQ(graph.get_edges().size(), 6);
+   ASSERT_TRUE(graph.get_edge(built.edges[2])->get_incident_nodes().empty());
+   ASSERT_EQ(graph.get_edge(built.edges[4])->get_incident_nodes()[1].get_shared_ptr(),
+             node.get_shared_ptr());
+   ASSERT_EQ(node->get_incident_edges().size(), 3);
+}
+
+TEST_F(HypergraphBuilderTestFixture, BuildNotifiesObserversAndTransactions)
+{
+   hypergraph<Pin> graph;
+   match_index<Pin> index(graph, cnr::Rule({{{1, 2}, {2, 3}}, {{1, 3}}}));
+
+   hypergraph_builder<Pin> builder;
+   builder.add_nodes(3);
+   builder.add_edges(std::vector<std::vector<int>>{{0, 1}, {1, 2}, {2, 0}});
+
+   {
+      transaction scope(graph);
+      builder.build(graph, 2);
+      ASSERT_EQ(index.size(), 3);
+   }
+
+   ASSERT_EQ(graph.get_nodes().size(), 0);
+   ASSERT_EQ(graph.get_edges().size(), 0);
+   ASSERT_EQ(index.size(), 0);
+}
+
+TEST_F(HypergraphBuilderTestFixture, MergeShards)
+{
+   constexpr size_t shard_count = 4;
+
+   hypergraph_builder<Pin> builder;
+   builder.add_nodes(10);
+   std::vector<hypergraph_builder<Pin>> shards(shard_count, builder.make_shard());
+   std::vector<std::thread> producers;
+
+   // every shard adds nodes of its own and links them to the shared ones
+   for (size_t shard = 0; shard < shard_count; ++shard)
+   {
+      producers.emplace_back([&shards, shard]
+      {
+         for (int value = 0; value < 100; ++value)
+         {
+            const uint32_t node = shards[shard].add_node(static_cast<int>(shard) * 100 + value);
+            shards[shard].add_edge({node, static_cast<uint32_t>(value % 10), node});
+         }
+      });
+   }
+
+   for (std::thread& producer : producers)
+   {
+      producer.join();
+   }
+
+   hypergraph<Pin> invalid;
+   ASSERT_THROW(shards[0].build(invalid), std::logic_error);
+   ASSERT_EQ(shards[3].add_node(0), 110);
+
+   builder.merge(shards, shard_count);
+   ASSERT_EQ(shards[0].node_count(), 0);
+   ASSERT_EQ(builder.node_count(), 411);
+   ASSERT_EQ(builder.edge_count(), 400);
+
+   hypergraph<Pin> graph;
+   auto built = builder.build(graph, 2);
+
+   for (size_t edge = 0; edge < built.edges.size(); ++edge)
+   {
+      auto nodes = graph.get_edge(built.edges[edge])->get_incident_nodes();
+      ASSERT_EQ(nodes.size(), 3);
+      ASSERT_EQ(nodes[0]->value_, static_cast<int>(edge));
+      ASSERT_EQ(nodes[1].get_shared_ptr(), graph.get_node(built.nodes[edge % 10]).get_shared_ptr());
+      ASSERT_EQ(nodes[2].get_shared_ptr(), nodes[0].get_shared_ptr());
+   }
+
+   ASSERT_EQ(graph.get_node(built.nodes[0])->get_incident_edges().size(), 40);
+   ASSERT_EQ(graph.get_node(built.nodes[410])->get_incident_edges().size(), 0);
+
+   // the builder was emptied by build, so the shards cannot refer to it anymore
+   std::vector<hypergraph_builder<Pin>> stale(1, shards[1]);
+   ASSERT_THROW(builder.merge(stale), std::logic_error);
+}
+} // namespace ctl::test
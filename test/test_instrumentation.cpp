@@ -0,0 +1,93 @@
+#include <numeric>
+
+#include <ctl/hypergraph.hpp>
+#include <ctl/instrumentation.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Probe : public ctl::node<Probe>
+{
+ public:
+   using ctl::node<Probe>::node;
+};
+
+// disabled timers hold no state and read no clock
+static_assert(instrumentation_enabled || std::is_empty_v<internal::operation_timer>);
+
+class InstrumentationTestFixture : public ::testing::Test
+{
+ public:
+   InstrumentationTestFixture() {}
+
+   ~InstrumentationTestFixture() {}
+
+ protected:
+   void SetUp() override { reset_instrumentation(); }
+
+   void TearDown() override {}
+};
+
+// runs one of every instrumented operation
+void exercise()
+{
+   hypergraph<Probe> graph(storage_mode::pooled);
+   auto nodes = graph.add_nodes(3);
+   auto edge  = graph.add_edge({nodes[0], nodes[1], nodes[2]});
+   graph.add_edge({nodes[1], nodes[2]});
+
+   ASSERT_EQ(nodes[0].get().count_adjacent_nodes(), 2);
+   ASSERT_TRUE(edge.get().is_incident_to(nodes[2]));
+
+   graph.remove_edge(edge);
+   graph.remove_node(nodes[1]);
+}
+
+TEST_F(InstrumentationTestFixture, Snapshot)
+{
+   exercise();
+   const instrumentation_stats stats = instrumentation_snapshot();
+
+   if constexpr (!instrumentation_enabled)
+   {
+      // disabled hooks record nothing
+      ASSERT_EQ(stats.allocations, 0);
+      ASSERT_EQ(stats.pointer_locks, 0);
+      ASSERT_EQ(stats.latency(instrumented_operation::add_edge).count, 0);
+      return;
+   }
+
+   ASSERT_EQ(stats.allocations, 5);
+   ASSERT_EQ(stats.deallocations, 5);
+   ASSERT_GT(stats.pointer_locks, 0);
+   ASSERT_GT(stats.scan_comparisons, 0);
+   ASSERT_EQ(stats.latency(instrumented_operation::add_edge).count, 2);
+   ASSERT_EQ(stats.latency(instrumented_operation::remove_edge).count, 1);
+   ASSERT_EQ(stats.latency(instrumented_operation::remove_node).count, 1);
+   ASSERT_EQ(stats.latency(instrumented_operation::adjacency_query).count, 1);
+
+   for (const latency_histogram& histogram : stats.latencies)
+   {
+      ASSERT_EQ(std::accumulate(histogram.buckets.begin(), histogram.buckets.end(), uint64_t{0}),
+                histogram.count);
+   }
+
+   // a pinned reference locks once, however often it is used
+   hypergraph<Probe> graph;
+   cxptr<Probe> node = graph.add_node();
+   reset_instrumentation();
+
+   pinned<Probe> probe = node.pin();
+
+   for (int access = 0; access < 10; ++access)
+   {
+      ASSERT_TRUE(probe->get_incident_edges().empty());
+   }
+
+   ASSERT_EQ(instrumentation_snapshot().pointer_locks, 1);
+
+   reset_instrumentation();
+   ASSERT_EQ(instrumentation_snapshot().allocations, 0);
+   ASSERT_EQ(instrumentation_snapshot().latency(instrumented_operation::add_edge).count, 0);
+}
+} // namespace ctl::test
@@ -0,0 +1,124 @@
+#include <ctl/multiway.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Point : public ctl::node<Point>
+{
+ public:
+   using ctl::node<Point>::node;
+};
+
+class MultiwayTestFixture : public ::testing::Test
+{
+ public:
+   MultiwayTestFixture() {}
+
+   ~MultiwayTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+TEST_F(MultiwayTestFixture, IsomorphicSuccessorsAreMerged)
+{
+   hypergraph<Point> initial;
+   auto nodes = initial.add_nodes(2);
+   initial.add_edge({nodes[0], nodes[1]});
+
+   // subdividing either edge of a path yields the same path
+   multiway_system<Point> system(initial, cnr::Rule({{{1, 2}}, {{1, 3}, {3, 2}}}));
+   ASSERT_EQ(system.state_count(), 1);
+
+   ASSERT_EQ(system.step(), 1);
+   ASSERT_EQ(system.get_branches().size(), 1);
+
+   ASSERT_EQ(system.step(), 1);
+   ASSERT_EQ(system.state_count(), 3);
+   ASSERT_EQ(system.get_branches().size(), 3);
+   ASSERT_EQ(system.get_branches()[1].source, system.get_branches()[2].source);
+   ASSERT_EQ(system.get_branches()[1].target, system.get_branches()[2].target);
+
+   auto path = system.materialize(2);
+   ASSERT_EQ(path.get_edges().size(), 3);
+   ASSERT_EQ(path.get_nodes().size(), 4);
+   ASSERT_EQ(system.get_state(2).generation, 2);
+   ASSERT_EQ(system.find_state(hash_canonical(path)), 2);
+}
+
+TEST_F(MultiwayTestFixture, ParallelExpansionIsDeterministic)
+{
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+
+   auto explore = [&rule](size_t thread_count)
+   {
+      hypergraph<Point> initial;
+      auto node = initial.add_node();
+      initial.add_edges({{node, node}, {node, node}});
+
+      multiway_options options;
+      options.thread_count = thread_count;
+      auto system = std::make_unique<multiway_system<Point>>(initial, rule, options);
+      system->run(3);
+      return system;
+   };
+
+   auto serial   = explore(1);
+   auto parallel = explore(4);
+   ASSERT_GT(serial->state_count(), 5);
+   ASSERT_EQ(parallel->state_count(), serial->state_count());
+   ASSERT_EQ(parallel->get_branches().size(), serial->get_branches().size());
+
+   for (size_t i = 0; i < serial->get_branches().size(); ++i)
+   {
+      ASSERT_EQ(parallel->get_branches()[i].source, serial->get_branches()[i].source);
+      ASSERT_EQ(parallel->get_branches()[i].target, serial->get_branches()[i].target);
+   }
+
+   for (size_t state = 0; state < serial->state_count(); ++state)
+   {
+      ASSERT_EQ(parallel->get_state(state).hash, serial->get_state(state).hash);
+      ASSERT_EQ(parallel->get_state_edges(state), serial->get_state_edges(state));
+   }
+}
+
+TEST_F(MultiwayTestFixture, BoundedStorage)
+{
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+   hypergraph<Point> initial;
+   auto node = initial.add_node();
+   initial.add_edges({{node, node}, {node, node}});
+
+   multiway_system<Point> retained(initial, rule);
+   retained.run(3);
+
+   multiway_options options;
+   options.retain_expanded_states = false;
+   multiway_system<Point> released(initial, rule, options);
+   released.run(3);
+
+   // releasing expanded states does not change the branch graph
+   ASSERT_EQ(released.state_count(), retained.state_count());
+   ASSERT_EQ(released.get_branches().size(), retained.get_branches().size());
+   ASSERT_FALSE(released.get_state(0).retained);
+   ASSERT_THROW(released.get_state_edges(0), std::logic_error);
+
+   for (auto state : released.get_frontier())
+   {
+      ASSERT_TRUE(is_isomorphic(released.materialize(state), retained.materialize(state)));
+   }
+
+   options.retain_expanded_states = true;
+   options.max_states              = 4;
+   multiway_system<Point> bounded(initial, rule, options);
+   bounded.run(3);
+   ASSERT_EQ(bounded.state_count(), 4);
+
+   for (auto branch : bounded.get_branches())
+   {
+      ASSERT_LT(branch.target, 4);
+   }
+}
+} // namespace ctl::test
@@ -0,0 +1,304 @@
+#include <algorithm>
+
+#include <ctl/rewriter.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Atom : public ctl::node<Atom>
+{
+ public:
+   using ctl::node<Atom>::node;
+};
+
+class RewriterTestFixture : public ::testing::Test
+{
+ public:
+   RewriterTestFixture() {}
+
+   ~RewriterTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+TEST_F(RewriterTestFixture, RuleRequiresTwoSides)
+{
+   ASSERT_THROW(cnr::Rule({{{1, 2}}}), std::invalid_argument);
+
+   cnr::Rule rule({{{1, 2}}, {{1, 2}, {2, 3}}});
+   ASSERT_EQ(rule.first.size(), 1);
+   ASSERT_EQ(rule.second.size(), 2);
+}
+
+TEST_F(RewriterTestFixture, GrowChain)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(2);
+   hypergraph.add_edge({nodes[0], nodes[1]});
+
+   rewriter<Atom> rewriter(hypergraph, cnr::Rule({{{1, 2}}, {{1, 2}, {2, 3}}}));
+   ASSERT_EQ(rewriter.run(3), 3);
+   ASSERT_EQ(rewriter.get_event_count(), 3);
+   ASSERT_EQ(hypergraph.get_edges().size(), 4);
+   ASSERT_EQ(hypergraph.get_nodes().size(), 5);
+}
+
+TEST_F(RewriterTestFixture, WolframModelSignature)
+{
+   hypergraph<Atom> hypergraph;
+   auto node = hypergraph.add_node();
+   hypergraph.add_edges({{node, node}, {node, node}});
+
+   rewriter<Atom> rewriter(hypergraph,
+                           cnr::Rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}}));
+
+   ASSERT_EQ(rewriter.run(5), 5);
+   ASSERT_EQ(hypergraph.get_edges().size(), 12);
+   ASSERT_EQ(hypergraph.get_nodes().size(), 6);
+
+   for (const hyperedge<Atom>& edge : hypergraph.edges())
+   {
+      ASSERT_EQ(std::ranges::distance(edge.incident_nodes()), 2);
+   }
+}
+
+TEST_F(RewriterTestFixture, FindMatchesUsesDistinctEdges)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(3);
+   hypergraph.add_edges({{nodes[0], nodes[1]}, {nodes[0], nodes[2]}, {nodes[1], nodes[2]}});
+
+   rewriter<Atom> rewriter(hypergraph, cnr::Rule({{{1, 2}, {1, 3}}, {{1, 2}}}));
+   auto matches = rewriter.find_matches();
+   ASSERT_EQ(matches.size(), 2);
+
+   for (auto& match : matches)
+   {
+      ASSERT_NE(match.edges[0], match.edges[1]);
+      ASSERT_EQ(match.nodes[0], nodes[0].get_shared_ptr().get());
+   }
+}
+
+TEST_F(RewriterTestFixture, RepeatedLabelsRequireEqualNodes)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(2);
+   hypergraph.add_edges({{nodes[0], nodes[1]}, {nodes[1], nodes[1]}});
+
+   rewriter<Atom> rewriter(hypergraph, cnr::Rule({{{1, 1}}, {{1, 2}}}));
+   auto matches = rewriter.find_matches();
+   ASSERT_EQ(matches.size(), 1);
+   ASSERT_EQ(matches[0].nodes[0], nodes[1].get_shared_ptr().get());
+
+   ASSERT_TRUE(rewriter.step());
+   ASSERT_FALSE(rewriter.step());
+   ASSERT_EQ(rewriter.get_event_count(), 1);
+   ASSERT_EQ(hypergraph.get_edges().size(), 2);
+}
+
+TEST_F(RewriterTestFixture, MatchIndexFollowsEdits)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(4);
+   auto edges = hypergraph.add_edges({{nodes[0], nodes[1]}, {nodes[0], nodes[2]}});
+
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}}});
+   rewriter<Atom> rescan(hypergraph, rule);
+   match_index<Atom> index(hypergraph, rule);
+   ASSERT_EQ(index.size(), 2);
+
+   auto edge = hypergraph.add_edge({nodes[0], nodes[3]});
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+   ASSERT_EQ(index.size(), 6);
+
+   hypergraph.remove_edge(edges[0]);
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+   ASSERT_EQ(index.size(), 2);
+
+   hypergraph.add_edge({nodes[3], nodes[3]});
+   hypergraph.add_edge({nodes[3], nodes[1]});
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+
+   hypergraph.remove_node(nodes[0]);
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+
+   for (auto& match : index.get_matches())
+   {
+      for (auto* matched_edge : match.edges)
+      {
+         ASSERT_TRUE(hypergraph.contains(matched_edge->get_handle()));
+      }
+   }
+}
+
+TEST_F(RewriterTestFixture, MatchIndexCountsMatchesOfChangedEdgesOnce)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(4);
+   hypergraph.add_edges({{nodes[0], nodes[1], nodes[3]}, {nodes[0], nodes[2], nodes[3]}});
+
+   // both edges change together and only form matches once nodes[3] is gone
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}}});
+   rewriter<Atom> rescan(hypergraph, rule);
+   match_index<Atom> index(hypergraph, rule);
+   ASSERT_EQ(index.size(), 0);
+
+   hypergraph.remove_node(nodes[3]);
+   ASSERT_EQ(rescan.find_matches().size(), 2);
+   ASSERT_EQ(index.size(), 2);
+}
+
+TEST_F(RewriterTestFixture, MatchIndexFollowsBulkRemoval)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(5);
+   hypergraph.add_edges({{nodes[0], nodes[1], nodes[3]},
+                         {nodes[0], nodes[2], nodes[3]},
+                         {nodes[0], nodes[4]},
+                         {nodes[4], nodes[4]}});
+
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}}});
+   rewriter<Atom> rescan(hypergraph, rule);
+   match_index<Atom> index(hypergraph, rule);
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+
+   hypergraph.remove_nodes({nodes[3]});
+   ASSERT_EQ(rescan.find_matches().size(), 6);
+   ASSERT_EQ(index.size(), 6);
+
+   hypergraph.remove_nodes({nodes[1], nodes[2], nodes[4]}, empty_edges::remove);
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+}
+
+TEST_F(RewriterTestFixture, IncrementalEvolutionMatchesRescan)
+{
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+
+   hypergraph<Atom> rescanned;
+   auto node = rescanned.add_node();
+   rescanned.add_edges({{node, node}, {node, node}});
+
+   hypergraph<Atom> incremental;
+   node = incremental.add_node();
+   incremental.add_edges({{node, node}, {node, node}});
+
+   rewriter<Atom> rescan_rewriter(rescanned, rule);
+   rewriter<Atom> incremental_rewriter(incremental, rule, match_strategy::incremental);
+
+   ASSERT_EQ(rescan_rewriter.run(20), 20);
+   ASSERT_EQ(incremental_rewriter.run(20), 20);
+   ASSERT_EQ(incremental.get_edges().size(), rescanned.get_edges().size());
+   ASSERT_EQ(incremental.get_nodes().size(), rescanned.get_nodes().size());
+   ASSERT_EQ(incremental_rewriter.find_matches().size(),
+             rewriter<Atom>(incremental, rule).find_matches().size());
+}
+
+std::vector<std::vector<uint64_t>> edge_signature(const hypergraph<Atom>& hypergraph)
+{
+   std::vector<std::vector<uint64_t>> signature;
+
+   for (const hyperedge<Atom>& edge : hypergraph.edges())
+   {
+      std::vector<uint64_t>& ids = signature.emplace_back();
+      ids.push_back(edge.get_id());
+
+      for (const Atom& node : edge.incident_nodes())
+      {
+         ids.push_back(node.get_id());
+      }
+   }
+
+   std::sort(signature.begin(), signature.end());
+   return signature;
+}
+
+TEST_F(RewriterTestFixture, GenerationAppliesDisjointMatches)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(8);
+
+   for (size_t i = 0; i + 1 < nodes.size(); ++i)
+   {
+      hypergraph.add_edge({nodes[i], nodes[i + 1]});
+   }
+
+   // subdivides every edge, all 7 matches are disjoint
+   rewriter<Atom> rewriter(hypergraph, cnr::Rule({{{1, 2}}, {{1, 3}, {3, 2}}}));
+   rewriter.set_thread_count(4);
+   ASSERT_EQ(rewriter.step_generation(), 7);
+   ASSERT_EQ(hypergraph.get_edges().size(), 14);
+   ASSERT_EQ(hypergraph.get_nodes().size(), 15);
+   ASSERT_EQ(rewriter.get_generation_count(), 1);
+}
+
+TEST_F(RewriterTestFixture, GenerationSkipsOverlappingMatches)
+{
+   hypergraph<Atom> hypergraph;
+   auto nodes = hypergraph.add_nodes(4);
+   hypergraph.add_edges({{nodes[0], nodes[1]}, {nodes[1], nodes[2]}, {nodes[2], nodes[3]}});
+
+   // matches of a two edge path share edges, so a generation can only take some of them
+   rewriter<Atom> rewriter(hypergraph, cnr::Rule({{{1, 2}, {2, 3}}, {{1, 3}}}));
+   ASSERT_EQ(rewriter.step_generation(), 1);
+   ASSERT_EQ(hypergraph.get_edges().size(), 2);
+}
+
+TEST_F(RewriterTestFixture, ParallelGenerationsMatchSequentialOrder)
+{
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+
+   auto evolve = [&rule](size_t thread_count)
+   {
+      hypergraph<Atom> hypergraph(storage_mode::pooled);
+      auto node = hypergraph.add_node();
+      hypergraph.add_edges({{node, node}, {node, node}});
+
+      rewriter<Atom> rewriter(hypergraph, rule);
+      rewriter.set_thread_count(thread_count);
+      rewriter.run_generations(4);
+      return edge_signature(hypergraph);
+   };
+
+   auto sequential = evolve(1);
+   ASSERT_GT(sequential.size(), 10);
+   ASSERT_EQ(evolve(4), sequential);
+
+   // applying the same selection one match at a time yields the same ids
+   hypergraph<Atom> hypergraph;
+   auto node = hypergraph.add_node();
+   hypergraph.add_edges({{node, node}, {node, node}});
+   rewriter<Atom> sequential_rewriter(hypergraph, rule);
+
+   for (size_t generation = 0; generation < 4; ++generation)
+   {
+      std::vector<rewriter<Atom>::match_type> selected;
+      std::vector<const hyperedge<Atom>*> used;
+
+      for (auto& match : sequential_rewriter.find_matches())
+      {
+         bool overlaps = false;
+
+         for (auto* edge : match.edges)
+         {
+            overlaps = overlaps || std::find(used.begin(), used.end(), edge) != used.end();
+         }
+
+         if (!overlaps)
+         {
+            used.insert(used.end(), match.edges.begin(), match.edges.end());
+            selected.push_back(match);
+         }
+      }
+
+      for (auto& match : selected)
+      {
+         sequential_rewriter.apply(match);
+      }
+   }
+
+   ASSERT_EQ(edge_signature(hypergraph), sequential);
+}
+} // namespace ctl::test
@@ -0,0 +1,196 @@
+#include <sstream>
+
+#include <ctl/text_formats.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Terminal : public ctl::node<Terminal>
+{
+ public:
+   using ctl::node<Terminal>::node;
+};
+
+class TextFormatsTestFixture : public ::testing::Test
+{
+ public:
+   TextFormatsTestFixture() {}
+
+   ~TextFormatsTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+// the node numbers of every edge in get_edges order
+std::vector<std::vector<uint32_t>> edge_lists(const hypergraph<Terminal>& graph)
+{
+   const compact_view<Terminal> view = graph.freeze();
+   std::vector<std::vector<uint32_t>> edges;
+
+   for (uint32_t edge = 0; edge < view.edge_count(); ++edge)
+   {
+      auto nodes = view.get_incident_nodes(edge);
+      edges.emplace_back(nodes.begin(), nodes.end());
+   }
+
+   return edges;
+}
+
+TEST_F(TextFormatsTestFixture, ReadHmetis)
+{
+   std::istringstream input("% a comment\n"
+                            "3 4 11\n"
+                            "2 1 2\r\n"
+                            "\n"
+                            "% weights follow the edges\n"
+                            "5   2 3 4\n"
+                            "1 4\t1 4\n"
+                            "7\n8\n9\n10\n");
+
+   hypergraph<Terminal> graph;
+   text_weights weights;
+   auto built = read_hmetis(input, graph, &weights);
+
+   ASSERT_EQ(built.nodes.size(), 4);
+   ASSERT_EQ(edge_lists(graph),
+             (std::vector<std::vector<uint32_t>>{{0, 1}, {1, 2, 3}, {3, 0, 3}}));
+   ASSERT_EQ(weights.edges, (std::vector<uint64_t>{2, 5, 1}));
+   ASSERT_EQ(weights.nodes, (std::vector<uint64_t>{7, 8, 9, 10}));
+}
+
+TEST_F(TextFormatsTestFixture, RoundTrips)
+{
+   hypergraph<Terminal> graph;
+   auto nodes = graph.add_nodes(5);
+   graph.add_edges({{nodes[0], nodes[4]}, {nodes[3], nodes[2], nodes[1]}, {nodes[2]}});
+
+   text_weights weights{{3, 1, 4}, {1, 5, 9, 2, 6, 5, 3, 5, 8, 9}, 2};
+
+   std::stringstream patoh;
+   write_patoh(graph, patoh, &weights);
+   ASSERT_EQ(patoh.str().substr(0, 14), "1 5 3 6 3 2\n3 ");
+
+   hypergraph<Terminal> from_patoh;
+   text_weights read_weights;
+   read_patoh(patoh, from_patoh, &read_weights);
+   ASSERT_EQ(edge_lists(from_patoh), edge_lists(graph));
+   ASSERT_EQ(read_weights.edges, weights.edges);
+   ASSERT_EQ(read_weights.nodes, weights.nodes);
+   ASSERT_EQ(read_weights.constraint_count, 2);
+
+   std::stringstream hmetis;
+   ASSERT_THROW(write_hmetis(graph, hmetis, &weights), std::invalid_argument);
+   weights.nodes.resize(5);
+   weights.constraint_count = 1;
+   write_hmetis(graph, hmetis, &weights);
+
+   hypergraph<Terminal> from_hmetis;
+   read_hmetis(hmetis, from_hmetis, &read_weights, 2);
+   ASSERT_EQ(edge_lists(from_hmetis), edge_lists(graph));
+   ASSERT_EQ(read_weights.nodes, weights.nodes);
+
+   std::stringstream edge_list;
+   write_edge_list(graph, edge_list);
+   ASSERT_EQ(edge_list.str(), "0 4\n3 2 1\n2\n");
+
+   hypergraph<Terminal> from_edge_list;
+   read_edge_list(edge_list, from_edge_list);
+   ASSERT_EQ(edge_lists(from_edge_list), edge_lists(graph));
+
+   graph.add_edge({});
+   ASSERT_THROW(write_edge_list(graph, edge_list), std::invalid_argument);
+}
+
+TEST_F(TextFormatsTestFixture, ReadPatohWithBaseZero)
+{
+   std::istringstream input("0 3 2 4\n0 1\n2 1\n");
+
+   hypergraph<Terminal> graph;
+   read_patoh(input, graph);
+   ASSERT_EQ(edge_lists(graph), (std::vector<std::vector<uint32_t>>{{0, 1}, {2, 1}}));
+}
+
+TEST_F(TextFormatsTestFixture, RejectsMalformedInput)
+{
+   auto read = [](const char* text, auto reader)
+   {
+      std::istringstream input(text);
+      hypergraph<Terminal> graph;
+      reader(input, graph);
+      return graph.get_edges().size();
+   };
+
+   auto hmetis = [](std::istream& input, hypergraph<Terminal>& graph) { read_hmetis(input, graph); };
+   auto patoh  = [](std::istream& input, hypergraph<Terminal>& graph) { read_patoh(input, graph); };
+   auto edges  = [](std::istream& input, hypergraph<Terminal>& graph) { read_edge_list(input, graph); };
+
+   ASSERT_EQ(read("2 2\n1 2\n2\n", hmetis), 2);
+   ASSERT_THROW(read("2 2\n1 2\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2\n1 3\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2\n0 1\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2 5\n1 2\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2\n1 -2\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2\n1 2x\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2\n1 2\n1\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2\n99999999999999999999999\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 2 1 3\n1 2\n", patoh), std::runtime_error);
+   ASSERT_THROW(read("4000000000 1\n", hmetis), std::runtime_error);
+   ASSERT_THROW(read("1 1 4000000000 2\n", patoh), std::runtime_error);
+   ASSERT_EQ(read("# comment\n0 1\n\n1 2 2\n", edges), 2);
+   ASSERT_THROW(read("0 a\n", edges), std::runtime_error);
+
+   try
+   {
+      read("1 2\n\n\n1 3\n", hmetis);
+      FAIL();
+   }
+   catch (const std::runtime_error& error)
+   {
+      ASSERT_EQ(std::string(error.what()), "line 4: node 3 does not exist.");
+   }
+}
+
+TEST_F(TextFormatsTestFixture, WritersReportFailedStreams)
+{
+   hypergraph<Terminal> graph;
+   auto nodes = graph.add_nodes(2);
+   graph.add_edge({nodes[0], nodes[1]});
+
+   // a stream buffer without room for a single character, like a full disk
+   struct full_buffer : std::streambuf
+   {
+   };
+
+   full_buffer buffer;
+   std::ostream full(&buffer);
+   ASSERT_THROW(write_hmetis(graph, full), std::runtime_error);
+
+   std::ostringstream closed;
+   closed.setstate(std::ios::badbit);
+   ASSERT_THROW(write_patoh(graph, closed), std::runtime_error);
+   ASSERT_THROW(write_edge_list(graph, closed), std::runtime_error);
+}
+
+TEST_F(TextFormatsTestFixture, ReaderHandlesChunkBoundaries)
+{
+   std::istringstream input("% 12\n 123 45\t6\n\n7890\n");
+   internal::text_reader reader(input, 2);
+   std::vector<uint64_t> numbers;
+   uint64_t number = 0;
+
+   while (reader.next_content_line("%"))
+   {
+      while (reader.read_integer(number))
+      {
+         numbers.push_back(number);
+      }
+
+      reader.end_line();
+   }
+
+   ASSERT_EQ(numbers, (std::vector<uint64_t>{123, 45, 6, 7890}));
+}
+} // namespace ctl::test
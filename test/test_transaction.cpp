@@ -0,0 +1,287 @@
+#include <ctl/rewriter.hpp>
+#include <ctl/transaction.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Vertex : public ctl::node<Vertex>
+{
+ public:
+   using ctl::node<Vertex>::node;
+};
+
+class TransactionTestFixture : public ::testing::Test
+{
+ public:
+   TransactionTestFixture() {}
+
+   ~TransactionTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+// the ids of all nodes and edges in iteration order, followed by every incidence list
+std::vector<std::vector<uint64_t>> describe(const hypergraph<Vertex>& graph)
+{
+   std::vector<std::vector<uint64_t>> description(2);
+
+   for (const Vertex& node : graph.nodes())
+   {
+      description[0].push_back(node.get_id());
+      std::vector<uint64_t>& edges = description.emplace_back();
+
+      for (const hyperedge<Vertex>& edge : node.incident_edges())
+      {
+         edges.push_back(edge.get_id());
+      }
+   }
+
+   for (const hyperedge<Vertex>& edge : graph.edges())
+   {
+      description[1].push_back(edge.get_id());
+      std::vector<uint64_t>& nodes = description.emplace_back();
+
+      for (const Vertex& node : edge.incident_nodes())
+      {
+         nodes.push_back(node.get_id());
+      }
+   }
+
+   return description;
+}
+
+TEST_F(TransactionTestFixture, RollbackRestoresGraph)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(4);
+   auto edges = graph.add_edges({{nodes[0], nodes[1], nodes[0]},
+                                 {nodes[1], nodes[2]},
+                                 {nodes[2], nodes[0]},
+                                 {nodes[3], nodes[1], nodes[3]}});
+
+   const auto before      = describe(graph);
+   const auto node_handle = nodes[1].get().get_handle();
+   const auto edge_handle = edges[2].get().get_handle();
+
+   graph.begin_transaction();
+   graph.remove_node(nodes[1]);
+   graph.remove_edge(edges[2]);
+   auto added = graph.add_node();
+   graph.add_edge({added, nodes[0], nodes[2]});
+   graph.remove_node(nodes[0]);
+   graph.remove_edge(edges[1]);
+   ASSERT_EQ(graph.get_transaction_depth(), 1);
+   ASSERT_EQ(graph.get_nodes().size(), 3);
+   ASSERT_EQ(graph.get_edges().size(), 3);
+   graph.rollback_transaction();
+
+   ASSERT_EQ(graph.get_transaction_depth(), 0);
+   ASSERT_EQ(describe(graph), before);
+   ASSERT_EQ(graph.get_node(node_handle).get().get_id(), 2);
+   ASSERT_EQ(graph.get_edge(edge_handle).get().get_id(), 7);
+   ASSERT_FALSE(added.is_valid());
+
+   // ids handed out inside the transaction are handed out again
+   ASSERT_EQ(graph.add_node().get().get_id(), 9);
+}
+
+TEST_F(TransactionTestFixture, RolledBackHandlesStayStale)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(2);
+   graph.remove_node(nodes[1]);
+
+   handle<Vertex> node_handle;
+   handle<hyperedge<Vertex>> edge_handle;
+
+   {
+      transaction scope(graph);
+      graph.remove_node(nodes[0]);
+      node_handle = graph.add_node().get().get_handle();
+      edge_handle = graph.add_edge({graph.add_node()}).get().get_handle();
+   }
+
+   ASSERT_TRUE(graph.contains(nodes[0].get().get_handle()));
+   ASSERT_FALSE(graph.contains(node_handle));
+   ASSERT_FALSE(graph.contains(edge_handle));
+
+   // new elements get new handles, in reused slots or not
+   for (size_t i = 0; i < 4; ++i)
+   {
+      auto node = graph.add_node();
+      auto edge = graph.add_edge({node});
+      ASSERT_NE(node.get().get_handle(), node_handle);
+      ASSERT_NE(edge.get().get_handle(), edge_handle);
+   }
+
+   ASSERT_FALSE(graph.contains(node_handle));
+   ASSERT_FALSE(graph.contains(edge_handle));
+}
+
+TEST_F(TransactionTestFixture, NestedTransactions)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(3);
+   auto edges = graph.add_edges({{nodes[0], nodes[1]}, {nodes[1], nodes[2]}});
+
+   const auto before = describe(graph);
+
+   transaction outer(graph);
+   graph.remove_edge(edges[0]);
+   const auto after_outer_change = describe(graph);
+
+   {
+      transaction inner(graph);
+      graph.remove_node(nodes[1]);
+      ASSERT_EQ(graph.get_transaction_depth(), 2);
+   }
+
+   ASSERT_EQ(describe(graph), after_outer_change);
+
+   {
+      transaction inner(graph);
+      graph.remove_node(nodes[2]);
+      inner.commit();
+      ASSERT_FALSE(inner.is_open());
+   }
+
+   ASSERT_EQ(graph.get_nodes().size(), 2);
+   outer.rollback();
+   ASSERT_EQ(describe(graph), before);
+   ASSERT_THROW(outer.commit(), std::logic_error);
+}
+
+TEST_F(TransactionTestFixture, CommitKeepsChanges)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(2);
+   auto edge  = graph.add_edge({nodes[0], nodes[1]});
+
+   ASSERT_THROW(graph.commit_transaction(), std::logic_error);
+   ASSERT_THROW(graph.rollback_transaction(), std::logic_error);
+
+   {
+      transaction scope(graph);
+      graph.remove_node(nodes[0]);
+      graph.add_node();
+      scope.commit();
+   }
+
+   ASSERT_EQ(graph.get_nodes().size(), 2);
+   ASSERT_EQ(edge.get().get_incident_nodes().size(), 1);
+   ASSERT_FALSE(nodes[0].is_valid());
+}
+
+TEST_F(TransactionTestFixture, ScopeEndedThroughGraph)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(3);
+
+   {
+      transaction scope(graph);
+      graph.remove_node(nodes[0]);
+      graph.commit_transaction();
+      ASSERT_FALSE(scope.is_open());
+   }
+
+   ASSERT_EQ(graph.get_nodes().size(), 2);
+
+   {
+      transaction outer(graph);
+      graph.remove_node(nodes[1]);
+
+      {
+         transaction inner(graph);
+         graph.remove_node(nodes[2]);
+         graph.rollback_transaction();
+         ASSERT_THROW(inner.commit(), std::logic_error);
+      }
+
+      // the inner scope did not roll back the outer transaction on its way out
+      ASSERT_EQ(graph.get_transaction_depth(), 1);
+      ASSERT_EQ(graph.get_nodes().size(), 1);
+      outer.commit();
+   }
+
+   ASSERT_EQ(graph.get_nodes().size(), 1);
+}
+
+TEST_F(TransactionTestFixture, RollbackUpdatesMatchIndex)
+{
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}, {1, 4}, {2, 4}, {3, 4}}});
+   hypergraph<Vertex> graph;
+   auto node = graph.add_node();
+   graph.add_edges({{node, node}, {node, node}});
+
+   rewriter<Vertex> incremental(graph, rule, match_strategy::incremental);
+   ASSERT_EQ(incremental.run(5), 5);
+
+   const auto before  = describe(graph);
+   const auto matches = incremental.find_matches().size();
+
+   {
+      transaction scope(graph);
+      ASSERT_EQ(incremental.run(10), 10);
+      ASSERT_GT(incremental.run_generations(2), 0);
+   }
+
+   ASSERT_EQ(describe(graph), before);
+   ASSERT_EQ(incremental.find_matches().size(), matches);
+   ASSERT_EQ(rewriter<Vertex>(graph, rule).find_matches().size(), matches);
+   ASSERT_EQ(incremental.run(10), 10);
+}
+
+TEST_F(TransactionTestFixture, BulkRemovalRollsBack)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(4);
+   auto edges = graph.add_edges({{nodes[0], nodes[1], nodes[0]},
+                                 {nodes[1], nodes[2]},
+                                 {nodes[3], nodes[3]}});
+
+   const auto before = describe(graph);
+
+   {
+      transaction scope(graph);
+      graph.remove_nodes({nodes[0], nodes[3]}, empty_edges::remove);
+      graph.remove_edges({edges[1]});
+      ASSERT_EQ(graph.get_edges().size(), 1);
+      ASSERT_EQ(graph.get_nodes().size(), 2);
+   }
+
+   ASSERT_EQ(describe(graph), before);
+}
+
+TEST_F(TransactionTestFixture, RollbackKeepsMatchIndexConsistent)
+{
+   hypergraph<Vertex> graph;
+   auto nodes = graph.add_nodes(4);
+   graph.add_edges({{nodes[0], nodes[1]}, {nodes[0], nodes[2]}, {nodes[3], nodes[3]}});
+
+   cnr::Rule rule({{{1, 2}, {1, 3}}, {{1, 2}}});
+   rewriter<Vertex> rescan(graph, rule);
+   match_index<Vertex> index(graph, rule);
+   ASSERT_EQ(index.size(), 2);
+
+   {
+      transaction scope(graph);
+      graph.remove_node(nodes[0]);
+      ASSERT_EQ(index.size(), rescan.find_matches().size());
+   }
+
+   // the restored edges are announced together and form matches with each other
+   ASSERT_EQ(rescan.find_matches().size(), 2);
+   ASSERT_EQ(index.size(), 2);
+
+   {
+      transaction scope(graph);
+      graph.remove_nodes({nodes[0], nodes[3]});
+      ASSERT_EQ(index.size(), rescan.find_matches().size());
+   }
+
+   ASSERT_EQ(index.size(), rescan.find_matches().size());
+}
+} // namespace ctl::test
@@ -0,0 +1,118 @@
+#include <ctl/versioned_hypergraph.hpp>
+#include <gtest/gtest.h>
+
+namespace ctl::test
+{
+class Cell : public ctl::node<Cell>
+{
+ public:
+   using ctl::node<Cell>::node;
+   explicit Cell(int value) : value_(value) {}
+   int value_ = 0;
+};
+
+class VersionedHypergraphTestFixture : public ::testing::Test
+{
+ public:
+   VersionedHypergraphTestFixture() {}
+
+   ~VersionedHypergraphTestFixture() {}
+
+ protected:
+   void SetUp() override {}
+
+   void TearDown() override {}
+};
+
+TEST_F(VersionedHypergraphTestFixture, AddAndRemove)
+{
+   versioned_hypergraph<Cell> graph;
+
+   auto a  = graph.add_node(1);
+   auto b  = graph.add_node(2);
+   auto c  = graph.add_node();
+   auto e1 = graph.add_edge({a, b, a});
+   auto e2 = graph.add_edge({b, c});
+
+   ASSERT_EQ(graph.node_count(), 3);
+   ASSERT_EQ(graph.edge_count(), 2);
+   ASSERT_EQ(graph.get_node(b).value_, 2);
+   ASSERT_EQ(graph.get_node(c).get_id(), 3);
+   ASSERT_EQ(graph.get_incident_edges(a).size(), 2);
+   ASSERT_EQ(graph.get_incident_nodes(e1).size(), 3);
+   ASSERT_THROW(graph.add_edge({a, 7}), std::out_of_range);
+
+   graph.remove_node(a);
+   ASSERT_FALSE(graph.contains_node(a));
+   ASSERT_TRUE(graph.contains_edge(e1));
+   ASSERT_EQ(graph.get_incident_nodes(e1).size(), 1);
+
+   graph.remove_edge(e2);
+   ASSERT_FALSE(graph.contains_edge(e2));
+   ASSERT_TRUE(graph.get_incident_edges(c).empty());
+   ASSERT_EQ(graph.get_edges(), std::vector<uint32_t>{e1});
+   ASSERT_EQ(graph.get_nodes(), (std::vector<uint32_t>{b, c}));
+}
+
+TEST_F(VersionedHypergraphTestFixture, SnapshotsAreIsolated)
+{
+   versioned_hypergraph<Cell> graph;
+   std::vector<uint32_t> nodes;
+
+   for (int i = 0; i < 1000; ++i)
+   {
+      nodes.push_back(graph.add_node(i));
+   }
+
+   for (size_t i = 0; i + 1 < nodes.size(); ++i)
+   {
+      graph.add_edge({nodes[i], nodes[i + 1]});
+   }
+
+   auto snapshot = graph.snapshot();
+   ASSERT_EQ(snapshot.get_version(), graph.get_version());
+
+   // a change copies only the chunks it touches
+   graph.add_edge({nodes[0], nodes[999]});
+   graph.update_node(nodes[500]).value_ = -1;
+   graph.remove_edge(0);
+
+   ASSERT_GT(graph.shared_chunk_count(), 20);
+   ASSERT_GT(graph.get_version(), snapshot.get_version());
+
+   ASSERT_EQ(snapshot.edge_count(), 999);
+   ASSERT_EQ(graph.edge_count(), 999);
+   ASSERT_TRUE(snapshot.contains_edge(0));
+   ASSERT_FALSE(graph.contains_edge(0));
+   ASSERT_EQ(snapshot.get_node(nodes[500]).value_, 500);
+   ASSERT_EQ(graph.get_node(nodes[500]).value_, -1);
+   ASSERT_EQ(snapshot.get_incident_edges(nodes[0]).size(), 1);
+   ASSERT_EQ(graph.get_incident_edges(nodes[0]).size(), 1);
+   ASSERT_EQ(graph.get_incident_edges(nodes[0])[0], 999);
+
+   // backtracking is assigning the snapshot back
+   graph = snapshot;
+   ASSERT_TRUE(graph.contains_edge(0));
+   ASSERT_EQ(graph.get_node(nodes[500]).value_, 500);
+}
+
+TEST_F(VersionedHypergraphTestFixture, ImportHypergraph)
+{
+   hypergraph<Cell> source;
+   auto a = source.add_node(5);
+   auto b = source.add_node(6);
+   source.add_edge({a, b});
+   source.add_edge({b, b});
+
+   versioned_hypergraph<Cell> graph(source);
+   ASSERT_EQ(graph.node_count(), 2);
+   ASSERT_EQ(graph.edge_count(), 2);
+   ASSERT_EQ(graph.get_node(0).value_, 5);
+   ASSERT_EQ(graph.get_node(0).get_id(), a->get_id());
+   ASSERT_TRUE(graph.get_node(1).get_incident_edges().empty());
+   ASSERT_EQ(graph.get_incident_edges(1).size(), 3);
+
+   // new nodes continue the ids of the source
+   ASSERT_EQ(graph.get_node(graph.add_node()).get_id(), source.add_node()->get_id());
+}
+} // namespace ctl::test